@@ -0,0 +1,92 @@
+# Measures how compile time and compiler memory grow with pipeline length.
+#
+# Usage: cmake -DCXX=<compiler> -DSOURCE_DIR=<dir with headers> -DWORK_DIR=<dir>
+#              -DSTAGES=8,32,64 -DOUTPUT=<csv> -P compile_benchmark.cmake
+#
+# For every N in STAGES a translation unit with an N-stage fbind chain over std::optional and an
+# N-field applicative json::Parser schema is generated and compiled once with -ftime-report (GCC).
+# One "stages,wall_seconds,memory_kb" row per N is written to OUTPUT.
+
+foreach(var CXX SOURCE_DIR WORK_DIR STAGES OUTPUT)
+    if(NOT DEFINED ${var})
+        message(FATAL_ERROR "compile_benchmark: ${var} is not set")
+    endif()
+endforeach()
+
+string(REPLACE "," ";" STAGES "${STAGES}")
+file(MAKE_DIRECTORY "${WORK_DIR}")
+file(WRITE "${OUTPUT}" "stages,wall_seconds,memory_kb\n")
+
+foreach(stages IN LISTS STAGES)
+    math(EXPR last "${stages} - 1")
+
+    set(bind_stages "")
+    set(field_params "")
+    set(field_sum "0.0")
+    set(field_parsers "")
+    foreach(idx RANGE ${last})
+        string(APPEND bind_stages "        >> [] (int value) { return std::optional<int>{value + ${idx}}; }\n")
+        if(idx GREATER 0)
+            string(APPEND field_params ", ")
+        endif()
+        string(APPEND field_params "json::JsonNumber f${idx}")
+        string(APPEND field_sum " + f${idx}")
+        string(APPEND field_parsers "                    * json::parse_field<json::JsonNumber>(object, \"f${idx}\"sv)\n")
+    endforeach()
+
+    set(source "${WORK_DIR}/pipeline_${stages}.cpp")
+    file(WRITE "${source}" "\
+// Generated by compile_benchmark.cmake
+#include \"functional_optional.hpp\"
+#include \"functional_partially_applicable.hpp\"
+#include \"json.hpp\"
+
+#include <optional>
+#include <string_view>
+
+std::optional<int> bind_pipeline(std::optional<int> value)
+{
+    using functional::operator>>;
+    return std::move(value)
+${bind_stages}        ;
+}
+
+json::Parser<double> parse_schema(const json::JsonValue &value)
+{
+    using namespace std::literals;
+    constexpr auto parser = json::with_object(
+            \"Schema\"sv,
+            [] (const json::JsonObject &object) {
+                using namespace functional;
+                return fpure<json::Parser>(partially_applicable([] (${field_params}) {
+                                                                    return ${field_sum};
+                                                                }))
+${field_parsers}                    ;
+            });
+    return parser(value);
+}
+")
+
+    execute_process(
+        COMMAND "${CXX}" -std=c++20 -ftime-report -I "${SOURCE_DIR}" -c "${source}" -o "${WORK_DIR}/pipeline_${stages}.o"
+        RESULT_VARIABLE result
+        ERROR_VARIABLE report)
+    if(NOT result EQUAL 0)
+        message(FATAL_ERROR "compile_benchmark: ${stages} stages failed to compile:\n${report}")
+    endif()
+
+    # " TOTAL : <usr> <sys> <wall> <memory>[kMG]"
+    string(REGEX MATCH "TOTAL *: *[0-9.]+ *[0-9.]+ *([0-9.]+) *([0-9]+)([kMG])" total "${report}")
+    if(NOT total)
+        message(FATAL_ERROR "compile_benchmark: no -ftime-report TOTAL line, is ${CXX} GCC?")
+    endif()
+    set(wall_seconds "${CMAKE_MATCH_1}")
+    set(memory_kb "${CMAKE_MATCH_2}")
+    if(CMAKE_MATCH_3 STREQUAL "M")
+        math(EXPR memory_kb "${memory_kb} * 1024")
+    elseif(CMAKE_MATCH_3 STREQUAL "G")
+        math(EXPR memory_kb "${memory_kb} * 1024 * 1024")
+    endif()
+    file(APPEND "${OUTPUT}" "${stages},${wall_seconds},${memory_kb}\n")
+    message(STATUS "compile_benchmark: ${stages} stages: ${wall_seconds} s, ${memory_kb} kB")
+endforeach()
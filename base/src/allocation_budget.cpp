@@ -0,0 +1,328 @@
+#include <iostream>
+
+#include "functional_applicative.hpp"
+#include "functional_functor.hpp"
+#include "functional_partially_applicable.hpp"
+#include "functional_monad.hpp"
+#include "functional_optional.hpp"
+#include "functional_compact_optional.hpp"
+#include "functional_unique_function.hpp"
+#include "json.hpp"
+#include "json_fields.hpp"
+#include "json_validation.hpp"
+#include "json_schema.hpp"
+#include "json_enum.hpp"
+#include "json_cache.hpp"
+#include "json_persistent.hpp"
+#include "json_constant.hpp"
+#include "json_path.hpp"
+#include "json_string.hpp"
+#include "json_context.hpp"
+#include "test_functional.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+// Counts every heap allocation of the process so that the scenarios below can be held to an
+// allocation budget. Run by ctest; prints one machine-readable line per scenario and exits
+// with a failure when any scenario goes over its budget.
+
+namespace
+{
+
+std::atomic<std::size_t> allocation_count{0};
+std::atomic<std::size_t> allocated_bytes{0};
+
+void *counted_allocate(std::size_t size, std::size_t alignment)
+{
+    allocation_count.fetch_add(1, std::memory_order_relaxed);
+    allocated_bytes.fetch_add(size, std::memory_order_relaxed);
+    void *pointer = alignment <= __STDCPP_DEFAULT_NEW_ALIGNMENT__
+        ? std::malloc(size ? size : 1)
+        : std::aligned_alloc(alignment, (size + alignment - 1) / alignment * alignment);
+    if (!pointer)
+    {
+        throw std::bad_alloc{};
+    }
+    return pointer;
+}
+
+} // anonymous namespace
+
+void *operator new(std::size_t size)
+{
+    return counted_allocate(size, __STDCPP_DEFAULT_NEW_ALIGNMENT__);
+}
+
+void *operator new[](std::size_t size)
+{
+    return counted_allocate(size, __STDCPP_DEFAULT_NEW_ALIGNMENT__);
+}
+
+void *operator new(std::size_t size, std::align_val_t alignment)
+{
+    return counted_allocate(size, static_cast<std::size_t>(alignment));
+}
+
+void *operator new[](std::size_t size, std::align_val_t alignment)
+{
+    return counted_allocate(size, static_cast<std::size_t>(alignment));
+}
+
+void operator delete(void *pointer) noexcept
+{
+    std::free(pointer);
+}
+
+void operator delete[](void *pointer) noexcept
+{
+    std::free(pointer);
+}
+
+void operator delete(void *pointer, std::size_t) noexcept
+{
+    std::free(pointer);
+}
+
+void operator delete[](void *pointer, std::size_t) noexcept
+{
+    std::free(pointer);
+}
+
+void operator delete(void *pointer, std::align_val_t) noexcept
+{
+    std::free(pointer);
+}
+
+void operator delete[](void *pointer, std::align_val_t) noexcept
+{
+    std::free(pointer);
+}
+
+void operator delete(void *pointer, std::size_t, std::align_val_t) noexcept
+{
+    std::free(pointer);
+}
+
+void operator delete[](void *pointer, std::size_t, std::align_val_t) noexcept
+{
+    std::free(pointer);
+}
+
+namespace
+{
+
+template<typename T>
+void do_not_optimize(const T &value)
+{
+    asm volatile("" : : "r"(&value) : "memory");
+}
+
+struct Budget final
+{
+    double allocations_per_op;
+    double bytes_per_op;
+};
+
+bool over_budget = false;
+
+template<typename Scenario>
+void run_scenario(std::string_view name, Budget budget, std::size_t iterations, const Scenario &scenario)
+{
+    do_not_optimize(scenario());
+    const std::size_t allocations_before = allocation_count.load(std::memory_order_relaxed);
+    const std::size_t bytes_before = allocated_bytes.load(std::memory_order_relaxed);
+    const auto start = std::chrono::steady_clock::now();
+    for (std::size_t idx = 0; idx < iterations; ++idx)
+    {
+        do_not_optimize(scenario());
+    }
+    const std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+    const double allocations = static_cast<double>(allocation_count.load(std::memory_order_relaxed) - allocations_before) / iterations;
+    const double bytes = static_cast<double>(allocated_bytes.load(std::memory_order_relaxed) - bytes_before) / iterations;
+    const bool ok = allocations <= budget.allocations_per_op && bytes <= budget.bytes_per_op;
+    over_budget = over_budget || !ok;
+    std::cout << "scenario=" << name
+              << " allocations_per_op=" << allocations
+              << " bytes_per_op=" << bytes
+              << " ns_per_op=" << elapsed.count() / iterations
+              << " budget_allocations=" << budget.allocations_per_op
+              << " budget_bytes=" << budget.bytes_per_op
+              << " status=" << (ok ? "ok" : "FAILED") << '\n';
+}
+
+using test_functional::MyStruct;
+using test_functional::parse_json;
+using test_functional::parse_json_fields;
+using test_functional::parse_records;
+
+// optional_test and the monad_test chains.
+void optional_scenarios(std::size_t iterations)
+{
+    using namespace functional;
+    run_scenario("optional_apply", {0, 0}, iterations, [] {
+        return fmap(partially_applicable([] (int a, double b) { return a + b; }), fpure<std::optional>(12))
+            * fpure<std::optional>(5.0);
+    });
+    run_scenario("optional_apply_empty", {0, 0}, iterations, [] {
+        return fmap(partially_applicable([] (int a, double b) { return a + b; }), fempty<std::optional, int>())
+            * fpure<std::optional>(5.0);
+    });
+    run_scenario("optional_bind_chain", {0, 0}, iterations, [] {
+        return fpure<std::optional>(15)
+            >> [] (auto val) { return fpure<std::optional>(val * 0.5); }
+            >> [] (auto val) { return fpure<std::optional>(static_cast<int>(val)); };
+    });
+    run_scenario("compact_optional_bind_chain", {0, 0}, iterations, [] {
+        return fpure<CompactOptional>(15.0)
+            >> [] (double val) { return fpure<CompactOptional>(val * 0.5); }
+            >> [] (double val) { return val > 0 ? fpure<CompactOptional>(val) : fempty<CompactOptional, double>(); };
+    });
+    DynamicPipeline<std::optional, int> pipeline{3};
+    pipeline.map([] (int val) { return val + 1; })
+            .bind([] (int val) { return val > 0 ? fpure<std::optional>(val * 2) : fempty<std::optional, int>(); })
+            .map([] (int val) { return val - 3; });
+    run_scenario("dynamic_pipeline_run", {0, 0}, iterations, [&pipeline] {
+        return pipeline.run(15);
+    });
+}
+
+// Schemas over a JsonValue: hand-written, derived, compiled, enums and validation.
+void json_parser_scenarios(std::size_t iterations)
+{
+    using namespace functional;
+    const json::JsonValue valid{json::JsonObject{{"a", {12.0}}, {"b", {12.0}}}};
+    const json::JsonValue invalid{json::JsonObject{{"a", {12.0}}}};
+    run_scenario("json_parse_success", {0, 0}, iterations, [&valid] {
+        return parse_json(valid);
+    });
+    // The error path builds its message eagerly; the budget guards against it growing.
+    run_scenario("json_parse_error", {3, 128}, iterations, [&invalid] {
+        return parse_json(invalid);
+    });
+    run_scenario("json_fields_success", {0, 0}, iterations, [&valid] {
+        return parse_json_fields(valid);
+    });
+    const json::CompiledSchema schema{"MyStruct", {{"a", json::SchemaType::integer}, {"b", json::SchemaType::number}}};
+    json::SchemaRow row;
+    run_scenario("json_schema_success", {0, 0}, iterations, [&] {
+        return schema.parse_into(valid, row);
+    });
+    enum class Level { debug, info, warning, error };
+    constexpr auto parse_level = json::enum_parser<Level>("Level", {
+        {"debug", Level::debug}, {"info", Level::info}, {"warning", Level::warning}, {"error", Level::error},
+    });
+    const json::JsonValue known_level{"warning"};
+    const json::JsonValue unknown_level{"verbose"};
+    run_scenario("json_enum_hit", {0, 0}, iterations, [&] {
+        return parse_level(known_level);
+    });
+    // A miss names the unknown string; the message buffer comes from the context when there is one.
+    run_scenario("json_enum_miss", {1, 64}, iterations, [&] {
+        return parse_level(unknown_level);
+    });
+    json::ParseContext enum_context;
+    run_scenario("json_enum_miss_recycled", {0, 0}, iterations, [&] {
+        auto missed = enum_context.parse(parse_level, unknown_level);
+        const bool failed = std::holds_alternative<json::ParseError>(missed.value);
+        enum_context.recycle(std::move(missed));
+        return failed;
+    });
+    // One arena per run, reset per document: errors and their paths land in the arena's own buffer.
+    json::ValidationArena validation_arena;
+    const json::JsonObject unvalidated{{"b", {json::JsonString{"two"}}}};
+    run_scenario("json_validation_arena_reset", {0, 0}, iterations, [&] {
+        using namespace std::literals;
+        validation_arena.reset();
+        const json::ValidationPath path{nullptr, {}, 7};
+        return fmap(partially_applicable([] (json::JsonNumber a, json::JsonNumber b) { return a + b; }),
+                    json::validate_field<json::JsonNumber>(validation_arena, unvalidated, "a"sv, &path))
+            * json::validate_field<json::JsonNumber>(validation_arena, unvalidated, "b"sv, &path);
+    });
+}
+
+// Documents that outlive one parse: cached results, shared snapshots, constants and paths.
+void json_document_scenarios(std::size_t iterations)
+{
+    const json::JsonValue valid{json::JsonObject{{"a", {12.0}}, {"b", {12.0}}}};
+    json::CachedParser<MyStruct> cached{parse_json};
+    run_scenario("json_cache_hit", {0, 0}, iterations, [&] {
+        return cached(valid);
+    });
+    // Readers of a shared document: taking a snapshot and reading a leaf only touch reference counts.
+    const json::JsonDocument document{json::PersistentJson::from_json(json::JsonValue{json::JsonObject{{"limits", valid}}})};
+    run_scenario("json_persistent_snapshot_read", {0, 0}, iterations, [&document] {
+        const json::PersistentJson snapshot = document.snapshot();
+        return parse_json(*snapshot.find("limits")->leaf());
+    });
+    constexpr auto defaults = json::constant<R"({"a": 12, "b": [1, 2, "three"]})">;
+    run_scenario("json_constant_lookup", {0, 0}, iterations, [&defaults] {
+        return defaults.root().find("b")->at(2)->string();
+    });
+    const json::JsonValue order{json::JsonObject{{"payload", {json::JsonObject{{"items", {json::JsonList{valid, valid}}}}}}}};
+    run_scenario("json_path_get", {0, 0}, iterations, [&order] {
+        return json::path<"/payload/items/1/b">.get<json::JsonNumber>(order);
+    });
+    const json::PathSet path_set{"/payload/items/0/a", "/payload/items/1/b", "/payload/missing"};
+    json::PathResults path_results;
+    path_set.evaluate(order, path_results);
+    run_scenario("json_path_set_reused_results", {0, 0}, iterations, [&] {
+        path_set.evaluate(order, path_results);
+        return path_results[1];
+    });
+}
+
+// Reused storage: decoded strings and documents built and parsed through a ParseContext.
+void json_storage_scenarios(std::size_t iterations)
+{
+    std::string string_storage;
+    run_scenario("json_string_borrowed", {0, 0}, iterations, [&string_storage] {
+        return json::decode_string("a string without escapes that is longer than the small buffer", string_storage);
+    });
+    static_cast<void>(json::decode_string(R"(warm \u00e9 up the storage with a long enough string)", string_storage));
+    run_scenario("json_string_decoded_reused_storage", {0, 0}, iterations, [&string_storage] {
+        return json::decode_string(R"(caf\u00e9 \"quoted\" and a tab\t)", string_storage);
+    });
+    // Steady-state document loop: build from recycled storage, parse a list of records and a broken
+    // record, hand everything back. After the warm-up call nothing is allocated.
+    const json::JsonValue invalid{json::JsonObject{{"a", {12.0}}}};
+    json::ParseContext context;
+    run_scenario("json_context_steady_state", {0, 0}, iterations, [&] {
+        json::JsonList records = context.acquire_list();
+        for (int idx = 0; idx < 8; ++idx)
+        {
+            json::JsonObject record = context.acquire_object();
+            record.emplace_back(context.acquire_string("a"), json::JsonValue{static_cast<double>(idx)});
+            record.emplace_back(context.acquire_string("b"), json::JsonValue{0.5});
+            records.push_back(json::JsonValue{std::move(record)});
+        }
+        json::JsonValue document{std::move(records)};
+        auto parsed = context.parse(parse_records, document);
+        const bool ok = std::holds_alternative<std::vector<MyStruct>>(parsed.value);
+        context.recycle(std::move(parsed));
+        auto failed = context.parse(parse_json, invalid);
+        context.recycle(std::move(failed));
+        context.recycle(std::move(document));
+        return ok;
+    });
+}
+
+} // anonymous namespace
+
+int main(int argc, char **argv)
+{
+    const std::size_t iterations = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 100'000;
+    optional_scenarios(iterations);
+    json_parser_scenarios(iterations);
+    json_document_scenarios(iterations);
+    json_storage_scenarios(iterations);
+    return over_budget ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -0,0 +1,542 @@
+#include <iostream>
+
+#include "functional_applicative.hpp"
+#include "functional_functor.hpp"
+#include "functional_partially_applicable.hpp"
+#include "functional_monad.hpp"
+#include "functional_optional.hpp"
+#include "functional_reader.hpp"
+#include "functional_state.hpp"
+#include "functional_unique_function.hpp"
+#include "functional_alternative.hpp"
+#include "functional_text_parser.hpp"
+#include "json.hpp"
+#include "json_fields.hpp"
+#include "json_schema.hpp"
+#include "json_enum.hpp"
+#include "json_cache.hpp"
+#include "json_persistent.hpp"
+#include "json_constant.hpp"
+#include "json_path.hpp"
+#include "json_string.hpp"
+#include "json_context.hpp"
+#include "test_functional.hpp"
+
+#include <chrono>
+#include <cstddef>
+#include <cstdlib>
+#include <functional>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+// Microbenchmarks for the functional core and the JSON combinators. Prints one JSON object per
+// line: {"benchmark": "<name>", "iterations": <n>, "ns_per_op": <t>}. An optional argument
+// restricts the run to benchmarks whose name contains it.
+
+namespace
+{
+
+using test_functional::MyStruct;
+using test_functional::parse_json;
+using test_functional::parse_json_fields;
+using test_functional::parse_records;
+
+template<typename T>
+void do_not_optimize(const T &value)
+{
+    asm volatile("" : : "r"(&value) : "memory");
+}
+
+// Hides a value from the optimizer so that chains are not folded at compile time.
+template<typename T>
+T opaque(T value)
+{
+    asm volatile("" : "+m"(value));
+    return value;
+}
+
+std::string_view filter;
+
+template<typename Func>
+void benchmark(std::string_view name, const Func &func)
+{
+    if (name.find(filter) == std::string_view::npos)
+    {
+        return;
+    }
+    using Clock = std::chrono::steady_clock;
+    constexpr std::chrono::milliseconds min_duration{50};
+    std::size_t iterations = 1;
+    while (true)
+    {
+        const auto start = Clock::now();
+        for (std::size_t idx = 0; idx < iterations; ++idx)
+        {
+            do_not_optimize(func());
+        }
+        const std::chrono::duration<double, std::nano> elapsed = Clock::now() - start;
+        if (elapsed >= min_duration || iterations >= (std::size_t{1} << 32))
+        {
+            std::cout << "{\"benchmark\": \"" << name
+                      << "\", \"iterations\": " << iterations
+                      << ", \"ns_per_op\": " << elapsed.count() / iterations << "}\n";
+            return;
+        }
+        iterations *= 2;
+    }
+}
+
+template<template<typename> typename T, bool IsMonad = true>
+void benchmark_chains(std::string_view instance)
+{
+    using namespace functional;
+    const std::string prefix = "chain/" + std::string(instance) + "/";
+    benchmark(prefix + "fmap", [] {
+        return fmap([] (int v) { return v + 3; },
+                    fmap([] (int v) { return v * 2; },
+                         fmap([] (int v) { return v + 1; }, fpure<T>(opaque(15)))));
+    });
+    benchmark(prefix + "fapply", [] {
+        return fmap(partially_applicable([] (int a, int b, int c) { return a * b + c; }), fpure<T>(opaque(15)))
+            * fpure<T>(opaque(2))
+            * fpure<T>(opaque(1));
+    });
+    if constexpr (IsMonad)
+    {
+        benchmark(prefix + "fbind", [] {
+            return fpure<T>(opaque(15))
+                >> [] (int v) { return fpure<T>(v + 1); }
+                >> [] (int v) { return fpure<T>(v * 2); }
+                >> [] (int v) { return fpure<T>(v + 3); };
+        });
+    }
+}
+
+void benchmark_handwritten_chains()
+{
+    benchmark("chain/handwritten/fmap", [] {
+        return (opaque(15) + 1) * 2 + 3;
+    });
+    benchmark("chain/handwritten/fapply", [] {
+        return opaque(15) * opaque(2) + opaque(1);
+    });
+    benchmark("chain/handwritten/optional", [] {
+        std::optional<int> value{opaque(15)};
+        if (value) value = *value + 1;
+        if (value) value = *value * 2;
+        if (value) value = *value + 3;
+        return value;
+    });
+}
+
+// Reader and State chains are single nested closures, so they should match the hand-written code.
+void benchmark_reader_state_chains()
+{
+    using namespace functional;
+    benchmark("chain/Reader/fbind", [] {
+        return (asks([] (int env) { return env; })
+                >> [] (int v) { return fpure<Reader>(v + 1); }
+                >> [] (int v) { return fpure<Reader>(v * 2); }
+                >> [] (int v) { return fpure<Reader>(v + 3); }).run(opaque(15));
+    });
+    benchmark("chain/State/fbind", [] {
+        return run_state(get_state()
+                >> [] (int v) { return fmap([v] (std::monostate) { return v; }, modify_state([] (int s) { return s + 1; })); }
+                >> [] (int v) { return fpure<State>(v * 2); }
+                >> [] (int v) { return fpure<State>(v + 3); }, opaque(15));
+    });
+}
+
+// Same stages as chain/std::optional/fbind, assembled at runtime.
+void benchmark_dynamic_pipeline()
+{
+    using namespace functional;
+    DynamicPipeline<std::optional, int> pipeline{3};
+    pipeline.bind([] (int v) { return fpure<std::optional>(v + 1); })
+            .bind([] (int v) { return fpure<std::optional>(v * 2); })
+            .bind([] (int v) { return fpure<std::optional>(v + 3); });
+    benchmark("chain/DynamicPipeline/std::optional", [&] {
+        return pipeline.run(opaque(15));
+    });
+    std::vector<std::function<std::optional<int>(std::optional<int>)>> std_function_stages{
+        [] (std::optional<int> v) { return fbind([] (int v) { return fpure<std::optional>(v + 1); }, std::move(v)); },
+        [] (std::optional<int> v) { return fbind([] (int v) { return fpure<std::optional>(v * 2); }, std::move(v)); },
+        [] (std::optional<int> v) { return fbind([] (int v) { return fpure<std::optional>(v + 3); }, std::move(v)); },
+    };
+    benchmark("chain/std::function/std::optional", [&] {
+        std::optional<int> value{opaque(15)};
+        for (auto &stage : std_function_stages)
+        {
+            value = stage(std::move(value));
+        }
+        return value;
+    });
+}
+
+// The token stream of the text_parser demo; ns_per_op over the size in the name gives the
+// throughput.
+void benchmark_text_parser()
+{
+    using namespace functional;
+    const auto word_count = fmap([] (std::vector<std::string_view> tokens) { return tokens.size(); }, many(token(take_while("a-z", 1))));
+    for (const std::size_t size : {1024, 1 << 16})
+    {
+        std::string words;
+        while (words.size() < size)
+        {
+            words += "lorem ipsum dolor sit amet ";
+        }
+        words.resize(size);
+        const std::string suffix = "/size=" + std::to_string(size);
+        benchmark("text_parser/tokens" + suffix, [&] { return parse_text(word_count, words).value; });
+        benchmark("text_parser/take_while" + suffix, [&] { return parse_text(take_while("a-z "), words).position; });
+    }
+}
+
+json::JsonObject make_object(std::size_t keys)
+{
+    json::JsonObject object;
+    object.reserve(keys);
+    for (std::size_t idx = 0; idx < keys; ++idx)
+    {
+        object.emplace_back("key" + std::to_string(idx), json::JsonValue{static_cast<double>(idx)});
+    }
+    return object;
+}
+
+void benchmark_parse_field()
+{
+    for (const std::size_t keys : {4, 16, 64, 256, 1024})
+    {
+        const json::JsonObject object = make_object(keys);
+        const std::string first_key = "key0";
+        const std::string last_key = "key" + std::to_string(keys - 1);
+        benchmark("parse_field/keys=" + std::to_string(keys) + "/first", [&] {
+            return json::parse_field<json::JsonNumber>(object, first_key);
+        });
+        benchmark("parse_field/keys=" + std::to_string(keys) + "/last", [&] {
+            return json::parse_field<json::JsonNumber>(object, last_key);
+        });
+        benchmark("parse_field/keys=" + std::to_string(keys) + "/missing", [&] {
+            return json::parse_field<json::JsonNumber>(object, "absent");
+        });
+    }
+}
+
+void benchmark_with_object()
+{
+    const json::JsonValue valid{json::JsonObject{{"a", {1.0}}, {"b", {2.0}}}};
+    const json::JsonValue missing_field{json::JsonObject{{"a", {1.0}}}};
+    const json::JsonValue not_object{json::JsonNumber{1.0}};
+    benchmark("with_object/success", [&] { return parse_json(valid); });
+    benchmark("with_object/error_missing_field", [&] { return parse_json(missing_field); });
+    benchmark("with_object/error_not_object", [&] { return parse_json(not_object); });
+    benchmark("with_fields/success", [&] { return parse_json_fields(valid); });
+    benchmark("with_fields/error_missing_field", [&] { return parse_json_fields(missing_field); });
+    const json::CompiledSchema schema{"MyStruct", {{"a", json::SchemaType::integer}, {"b", json::SchemaType::number}}};
+    json::SchemaRow row;
+    benchmark("schema/success", [&] { return schema.parse_into(valid, row); });
+    benchmark("schema/error_missing_field", [&] { return schema.parse_into(missing_field, row); });
+}
+
+void benchmark_falternate()
+{
+    using namespace functional;
+    const json::JsonObject object = make_object(4);
+    for (const std::size_t alternatives : {1, 2, 4, 8, 16})
+    {
+        // Every alternative but the last fails on a missing key.
+        benchmark("falternate/parser/alternatives=" + std::to_string(alternatives), [&] {
+            auto result = json::parse_field<json::JsonNumber>(object, alternatives == 1 ? "key0" : "absent");
+            for (std::size_t idx = 1; idx < alternatives; ++idx)
+            {
+                result = std::move(result) | json::parse_field<json::JsonNumber>(object, idx + 1 == alternatives ? "key0" : "absent");
+            }
+            return result;
+        });
+        benchmark("falternate/optional/alternatives=" + std::to_string(alternatives), [&] {
+            auto result = alternatives == 1 ? fpure<std::optional>(opaque(1)) : fempty<std::optional, int>();
+            for (std::size_t idx = 1; idx < alternatives; ++idx)
+            {
+                result = std::move(result) | (idx + 1 == alternatives ? fpure<std::optional>(opaque(1)) : fempty<std::optional, int>());
+            }
+            return result;
+        });
+    }
+}
+
+enum class Month { jan, feb, mar, apr, may, jun, jul, aug, sep, oct, nov, dec };
+
+void benchmark_enum_parser()
+{
+    using namespace std::literals;
+    constexpr auto parse_month = json::enum_parser<Month>("Month"sv, {
+        {"january", Month::jan}, {"february", Month::feb}, {"march", Month::mar}, {"april", Month::apr},
+        {"may", Month::may}, {"june", Month::jun}, {"july", Month::jul}, {"august", Month::aug},
+        {"september", Month::sep}, {"october", Month::oct}, {"november", Month::nov}, {"december", Month::dec},
+    });
+    // What services write by hand today.
+    constexpr auto parse_month_chain = json::with_string("Month"sv, [] (const json::JsonString &name) {
+        if (name == "january") return json::Parser<Month>{Month::jan};
+        else if (name == "february") return json::Parser<Month>{Month::feb};
+        else if (name == "march") return json::Parser<Month>{Month::mar};
+        else if (name == "april") return json::Parser<Month>{Month::apr};
+        else if (name == "may") return json::Parser<Month>{Month::may};
+        else if (name == "june") return json::Parser<Month>{Month::jun};
+        else if (name == "july") return json::Parser<Month>{Month::jul};
+        else if (name == "august") return json::Parser<Month>{Month::aug};
+        else if (name == "september") return json::Parser<Month>{Month::sep};
+        else if (name == "october") return json::Parser<Month>{Month::oct};
+        else if (name == "november") return json::Parser<Month>{Month::nov};
+        else if (name == "december") return json::Parser<Month>{Month::dec};
+        return json::Parser<Month>{json::ParseError{"Unknown JSON string \"" + name + "\" for Month"}};
+    });
+    const json::JsonValue last{"december"};
+    const json::JsonValue unknown{"smarch"};
+    benchmark("enum_parser/hash/last", [&] { return parse_month(last); });
+    benchmark("enum_parser/hash/miss", [&] { return parse_month(unknown); });
+    benchmark("enum_parser/if_chain/last", [&] { return parse_month_chain(last); });
+    benchmark("enum_parser/if_chain/miss", [&] { return parse_month_chain(unknown); });
+}
+
+void benchmark_cached_parser()
+{
+    for (const std::size_t points : {1, 16, 256})
+    {
+        json::JsonList list;
+        for (std::size_t idx = 0; idx < points; ++idx)
+        {
+            list.push_back(json::JsonValue{json::JsonObject{{"a", {static_cast<double>(idx)}}, {"b", {2.0}}}});
+        }
+        const json::JsonValue document{std::move(list)};
+        json::CachedParser<std::vector<MyStruct>> cached{parse_records};
+        const std::string suffix = "/points=" + std::to_string(points);
+        benchmark("cached_parser/hit" + suffix, [&] { return cached(document); });
+        benchmark("cached_parser/uncached" + suffix, [&] { return parse_records(document); });
+        benchmark("cached_parser/content_hash" + suffix, [&] { return json::content_hash(document); });
+    }
+}
+
+void benchmark_persistent_update()
+{
+    for (const std::size_t keys : {16, 256, 4096})
+    {
+        json::JsonObject object;
+        for (std::size_t idx = 0; idx < keys; ++idx)
+        {
+            object.emplace_back("key" + std::to_string(idx), json::JsonValue{json::JsonObject{{"a", {1.0}}, {"b", {2.0}}}});
+        }
+        const json::JsonValue document{std::move(object)};
+        const json::PersistentJson persistent = json::PersistentJson::from_json(document);
+        const json::JsonDocument shared{persistent};
+        const json::PersistentJson changed = json::PersistentJson::leaf(json::JsonValue{json::JsonObject{{"a", {3.0}}, {"b", {4.0}}}});
+        const std::string suffix = "/keys=" + std::to_string(keys);
+        // Today's alternative: copy the whole document and change the field in the copy.
+        benchmark("persistent/copy_update" + suffix, [&] {
+            json::JsonValue copy = document;
+            std::get<json::JsonObject>(copy.value)[keys / 2].second = *changed.leaf();
+            return copy;
+        });
+        benchmark("persistent/path_copy_update" + suffix, [&] {
+            return persistent.set("key" + std::to_string(keys / 2), changed);
+        });
+        benchmark("persistent/snapshot_find" + suffix, [&] {
+            return shared.snapshot().find("key7") != nullptr;
+        });
+    }
+}
+
+void benchmark_constant()
+{
+    constexpr auto defaults = json::constant<R"({"a": 1, "b": -2.5, "name": "origin"})">;
+    // Startup work per embedded default without and with compile-time decoding.
+    benchmark("constant/to_json_and_parse", [&] { return parse_json_fields(defaults.root().to_json()); });
+    benchmark("constant/find", [&] { return defaults.root().find("b")->number(); });
+}
+
+void benchmark_path()
+{
+    using namespace std::literals;
+    json::JsonList items;
+    for (std::size_t idx = 0; idx < 8; ++idx)
+    {
+        items.push_back(json::JsonValue{json::JsonObject{{"sku", {"item"}}, {"quantity", {1.0}}, {"price", {static_cast<double>(idx)}}}});
+    }
+    const json::JsonValue document{json::JsonObject{
+        {"id", {"order"}},
+        {"payload", {json::JsonObject{{"customer", {"someone"}}, {"items", {std::move(items)}}, {"total", {28.0}}}}},
+    }};
+    // Today's way: one parse_field per level, each copying its subobject through json_type_parser.
+    benchmark("path/nested_parse_field", [&] {
+        const auto payload = json::parse_field<json::JsonObject>(std::get<json::JsonObject>(document.value), "payload"sv);
+        const auto *payload_object = std::get_if<json::JsonObject>(&payload.value);
+        if (!payload_object)
+        {
+            return json::Parser<json::JsonNumber>{json::ParseError{"Expected payload"}};
+        }
+        const auto items = json::parse_field<json::JsonList>(*payload_object, "items"sv);
+        const auto *items_list = std::get_if<json::JsonList>(&items.value);
+        if (!items_list || items_list->size() <= 3)
+        {
+            return json::Parser<json::JsonNumber>{json::ParseError{"Expected items"}};
+        }
+        return json::with_object("Item"sv, [] (const json::JsonObject &item) {
+            return json::parse_field<json::JsonNumber>(item, "price"sv);
+        })((*items_list)[3]);
+    });
+    benchmark("path/static", [&] { return json::path<"/payload/items/3/price">.get<json::JsonNumber>(document); });
+    const json::Path runtime_path{"/payload/items/3/price"};
+    benchmark("path/runtime", [&] { return runtime_path.get<json::JsonNumber>(document); });
+    const json::PathSet path_set{"/id", "/payload/customer", "/payload/total", "/payload/items/0/price", "/payload/items/7/price"};
+    json::PathResults results;
+    benchmark("path/set_of_5", [&] { path_set.evaluate(document, results); return results[4]; });
+    const json::Path paths[] = {
+        json::Path{"/id"}, json::Path{"/payload/customer"}, json::Path{"/payload/total"},
+        json::Path{"/payload/items/0/price"}, json::Path{"/payload/items/7/price"},
+    };
+    benchmark("path/separate_5", [&] {
+        const json::JsonValue *found = nullptr;
+        for (const json::Path &path : paths)
+        {
+            found = path.find(document);
+        }
+        return found;
+    });
+}
+
+// What the ingest pipeline does today: a byte-at-a-time UTF-8 check, then an unescape pass that
+// always copies.
+bool scalar_validate_and_unescape(std::string_view raw, std::string &output)
+{
+    for (std::size_t position = 0; position < raw.size();)
+    {
+        const auto byte = static_cast<unsigned char>(raw[position]);
+        const std::size_t size = byte < 0x80 ? 1 : json::detail::utf8_sequence_size(raw, position);
+        if (size == 0)
+        {
+            return false;
+        }
+        position += size;
+    }
+    output.clear();
+    for (std::size_t position = 0; position < raw.size();)
+    {
+        if (raw[position] != '\\')
+        {
+            output.push_back(raw[position++]);
+            continue;
+        }
+        position = json::detail::decode_escape(raw, position, output);
+        if (position == 0)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+void benchmark_string()
+{
+    const auto repeat = [] (std::string_view piece, std::size_t size) {
+        std::string text;
+        while (text.size() < size)
+        {
+            text += piece;
+        }
+        return text;
+    };
+    for (const std::size_t size : {64, 1024})
+    {
+        const std::pair<std::string, std::string> inputs[] = {
+            {"ascii", repeat("request served in 12 ms by worker 7; ", size)},
+            {"utf8", repeat("Gr\xc3\xbc\xc3\x9f aus K\xc3\xb6ln \xe2\x82\xac ", size)},
+            {"escaped", repeat(R"(path \"C:\\logs\" line\n)", size)},
+        };
+        for (const auto &[name, text] : inputs)
+        {
+            const std::string suffix = "/" + name + "/size=" + std::to_string(size);
+            std::string storage;
+            benchmark("string/scalar" + suffix, [&] { return scalar_validate_and_unescape(text, storage); });
+            benchmark("string/decode_string" + suffix, [&] { return json::decode_string(text, storage); });
+        }
+    }
+}
+
+// One document per iteration, built, parsed and dropped; with a context its storage is recycled.
+void benchmark_context()
+{
+    for (const std::size_t points : {16, 256})
+    {
+        const std::string suffix = "/points=" + std::to_string(points);
+        benchmark("context/fresh" + suffix, [&] {
+            json::JsonList list;
+            for (std::size_t idx = 0; idx < points; ++idx)
+            {
+                json::JsonObject record;
+                record.emplace_back("a", json::JsonValue{static_cast<double>(idx)});
+                record.emplace_back("b", json::JsonValue{2.0});
+                list.push_back(json::JsonValue{std::move(record)});
+            }
+            const json::JsonValue document{std::move(list)};
+            return parse_records(document);
+        });
+        json::ParseContext context;
+        benchmark("context/recycled" + suffix, [&] {
+            json::JsonList list = context.acquire_list();
+            for (std::size_t idx = 0; idx < points; ++idx)
+            {
+                json::JsonObject record = context.acquire_object();
+                record.emplace_back("a", json::JsonValue{static_cast<double>(idx)});
+                record.emplace_back("b", json::JsonValue{2.0});
+                list.push_back(json::JsonValue{std::move(record)});
+            }
+            json::JsonValue document{std::move(list)};
+            auto parsed = context.parse(parse_records, document);
+            const bool ok = std::holds_alternative<std::vector<MyStruct>>(parsed.value);
+            context.recycle(std::move(parsed));
+            context.recycle(std::move(document));
+            return ok;
+        });
+    }
+    const json::JsonValue broken{json::JsonList{json::JsonValue{json::JsonObject{{"a", {1.0}}}}}};
+    benchmark("context/error_fresh", [&] { return parse_records(broken); });
+    json::ParseContext context;
+    benchmark("context/error_recycled", [&] {
+        auto parsed = context.parse(parse_records, broken);
+        const bool ok = std::holds_alternative<json::ParseError>(parsed.value);
+        context.recycle(std::move(parsed));
+        return ok;
+    });
+}
+
+} // anonymous namespace
+
+int main(int argc, char **argv)
+{
+    if (argc > 1)
+    {
+        filter = argv[1];
+    }
+    benchmark_chains<test_functional::MyMonad>("MyMonad");
+    benchmark_chains<test_functional::MyMonadMethods>("MyMonadMethods");
+    benchmark_chains<std::optional>("std::optional");
+    benchmark_chains<json::Parser, false>("json::Parser");
+    benchmark_handwritten_chains();
+    benchmark_reader_state_chains();
+    benchmark_dynamic_pipeline();
+    benchmark_text_parser();
+    benchmark_parse_field();
+    benchmark_with_object();
+    benchmark_falternate();
+    benchmark_enum_parser();
+    benchmark_cached_parser();
+    benchmark_persistent_update();
+    benchmark_constant();
+    benchmark_path();
+    benchmark_string();
+    benchmark_context();
+    return EXIT_SUCCESS;
+}
@@ -27,16 +27,20 @@ constexpr auto fempty() noexcept
 
 template<template<typename> typename T, typename InputValue, typename InputWrapped>
     requires std::is_same_v<T<InputValue>, std::remove_cvref_t<InputWrapped>>
-constexpr auto falternate(T<InputValue> &&lhs, InputWrapped &&rhs)
+#define CALL_TEXT FunctionalTraits<T>::alternate(std::move(lhs), std::forward<InputWrapped>(rhs))
+constexpr auto falternate(T<InputValue> &&lhs, InputWrapped &&rhs) noexcept(noexcept(CALL_TEXT))
 {
-    return FunctionalTraits<T>::alternate(std::move(lhs), std::forward<InputWrapped>(rhs));
+    return CALL_TEXT;
+#undef CALL_TEXT
 }
 
 template<template<typename> typename T, typename InputValue, typename InputWrapped>
     requires std::is_same_v<T<InputValue>, std::remove_cvref_t<InputWrapped>>
-constexpr auto falternate(const T<InputValue> &lhs, InputWrapped &&rhs)
+#define CALL_TEXT FunctionalTraits<T>::alternate(lhs, std::forward<InputWrapped>(rhs))
+constexpr auto falternate(const T<InputValue> &lhs, InputWrapped &&rhs) noexcept(noexcept(CALL_TEXT))
 {
-    return FunctionalTraits<T>::alternate(lhs, std::forward<InputWrapped>(rhs));
+    return CALL_TEXT;
+#undef CALL_TEXT
 }
 
 template<template<typename> typename T>
@@ -46,9 +50,11 @@ concept Alternative = Applicative<T> && requires(T<detail::MoveOnlyData> t1, T<d
 };
 
 template<typename Lhs, typename Rhs>
-constexpr auto operator|(Lhs &&lhs, Rhs &&rhs)
+#define CALL_TEXT falternate(std::forward<Lhs>(lhs), std::forward<Rhs>(rhs))
+constexpr auto operator|(Lhs &&lhs, Rhs &&rhs) noexcept(noexcept(CALL_TEXT))
 {
-    return falternate(std::forward<Lhs>(lhs), std::forward<Rhs>(rhs));
+    return CALL_TEXT;
+#undef CALL_TEXT
 }
 
 } // namespace functional
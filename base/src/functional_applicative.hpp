@@ -7,16 +7,20 @@ namespace functional
 
 template<template<typename> typename T, typename Func, typename Input>
     requires is_instance_v<T, Input>
-constexpr auto fapply(T<Func> &&func, Input &&input)
+#define CALL_TEXT FunctionalTraits<T>::apply(std::move(func), std::forward<Input>(input))
+constexpr auto fapply(T<Func> &&func, Input &&input) noexcept(noexcept(CALL_TEXT))
 {
-    return FunctionalTraits<T>::apply(std::move(func), std::forward<Input>(input));
+    return CALL_TEXT;
+#undef CALL_TEXT
 }
 
 template<template<typename> typename T, typename Func, typename Input>
     requires is_instance_v<T, Input>
-constexpr auto fapply(const T<Func> &func, Input &&input)
+#define CALL_TEXT FunctionalTraits<T>::apply(func, std::forward<Input>(input))
+constexpr auto fapply(const T<Func> &func, Input &&input) noexcept(noexcept(CALL_TEXT))
 {
-    return FunctionalTraits<T>::apply(func, std::forward<Input>(input));
+    return CALL_TEXT;
+#undef CALL_TEXT
 }
 
 template<template<typename> typename T>
@@ -25,9 +29,11 @@ concept Applicative = Functor<T> && requires(T<detail::MoveOnlyFunctionObject> f
 };
 
 template<typename Lhs, typename Rhs>
-constexpr auto operator*(Lhs &&lhs, Rhs &&rhs)
+#define CALL_TEXT fapply(std::forward<Lhs>(lhs), std::forward<Rhs>(rhs))
+constexpr auto operator*(Lhs &&lhs, Rhs &&rhs) noexcept(noexcept(CALL_TEXT))
 {
-    return fapply(std::forward<Lhs>(lhs), std::forward<Rhs>(rhs));
+    return CALL_TEXT;
+#undef CALL_TEXT
 }
 
 } // namespace functional
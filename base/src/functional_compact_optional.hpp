@@ -0,0 +1,376 @@
+#pragma once
+
+#include <bit>
+#include <concepts>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#include "functional_monad.hpp"
+#include "functional_alternative.hpp"
+#include "functional_foldable.hpp"
+
+namespace functional
+{
+
+// A niche tells CompactOptional which value of T encodes "empty", so no separate flag is stored.
+
+// Quiet NaN with a payload that arithmetic never produces: computed NaNs stay ordinary values.
+struct NanNiche final
+{
+    template<std::floating_point T>
+    static constexpr T empty_value() noexcept
+    {
+        if constexpr (sizeof(T) == sizeof(std::uint64_t))
+        {
+            return std::bit_cast<T>(std::uint64_t{0x7ff8'5c0f'fee0'0001});
+        }
+        else
+        {
+            static_assert(sizeof(T) == sizeof(std::uint32_t), "unsupported floating point format");
+            return std::bit_cast<T>(std::uint32_t{0x7fc5'c0f1});
+        }
+    }
+
+    template<std::floating_point T>
+    static constexpr bool is_empty(const T &value) noexcept
+    {
+        using Bits = std::conditional_t<sizeof(T) == sizeof(std::uint64_t), std::uint64_t, std::uint32_t>;
+        return std::bit_cast<Bits>(value) == std::bit_cast<Bits>(empty_value<T>());
+    }
+};
+
+struct NullNiche final
+{
+    template<typename T>
+        requires std::is_pointer_v<T>
+    static constexpr T empty_value() noexcept
+    {
+        return nullptr;
+    }
+
+    template<typename T>
+        requires std::is_pointer_v<T>
+    static constexpr bool is_empty(const T &value) noexcept
+    {
+        return value == nullptr;
+    }
+};
+
+template<auto Sentinel>
+struct SentinelNiche final
+{
+    template<typename T>
+        requires std::same_as<T, decltype(Sentinel)>
+    static constexpr T empty_value() noexcept
+    {
+        return Sentinel;
+    }
+
+    template<typename T>
+        requires std::same_as<T, decltype(Sentinel)>
+    static constexpr bool is_empty(const T &value) noexcept
+    {
+        return value == Sentinel;
+    }
+};
+
+// No spare value: falls back to std::optional storage.
+struct NoNiche final
+{
+};
+
+// Specialize for your own types so that CompactOptional<RowId> is compact and takes part in
+// fmap/fapply/fbind/falternate:
+//
+//     template<>
+//     struct functional::DefaultNiche<RowId> final
+//     {
+//         using type = functional::SentinelNiche<RowId{~0u}>;
+//     };
+//
+// Only pick a niche the type never holds as a value: storing it throws. That is why pointers
+// keep std::optional storage by default (a null pointer is an ordinary value); opt in with
+// CompactOptional<T *, NullNiche> where null never occurs.
+template<typename T>
+struct DefaultNiche final
+{
+    using type = NoNiche;
+};
+
+template<std::floating_point T>
+    requires std::numeric_limits<T>::is_iec559
+struct DefaultNiche<T> final
+{
+    using type = NanNiche;
+};
+
+namespace detail
+{
+
+template<typename T, typename Niche>
+class CompactStorage
+{
+public:
+    constexpr CompactStorage() noexcept
+        : value_(Niche::template empty_value<T>())
+    {
+    }
+
+    constexpr explicit CompactStorage(T value)
+        : value_(value)
+    {
+        if (Niche::is_empty(value_))
+        {
+            throw std::invalid_argument("the niche value cannot be stored in a CompactOptional");
+        }
+    }
+
+    constexpr bool has_value() const noexcept
+    {
+        return !Niche::is_empty(value_);
+    }
+
+    constexpr T &get() & noexcept
+    {
+        return value_;
+    }
+
+    constexpr const T &get() const & noexcept
+    {
+        return value_;
+    }
+
+private:
+    T value_;
+};
+
+template<typename T>
+class CompactStorage<T, NoNiche>
+{
+public:
+    constexpr CompactStorage() noexcept = default;
+
+    constexpr explicit CompactStorage(T &&value) noexcept(std::is_nothrow_move_constructible_v<T>)
+        : value_(std::move(value))
+    {
+    }
+
+    constexpr explicit CompactStorage(const T &value) noexcept(std::is_nothrow_copy_constructible_v<T>)
+        : value_(value)
+    {
+    }
+
+    constexpr bool has_value() const noexcept
+    {
+        return value_.has_value();
+    }
+
+    constexpr T &get() & noexcept
+    {
+        return *value_;
+    }
+
+    constexpr const T &get() const & noexcept
+    {
+        return *value_;
+    }
+
+private:
+    std::optional<T> value_;
+};
+
+} // namespace detail
+
+// Same interface subset as std::optional, but sizeof(CompactOptional<T>) == sizeof(T) whenever
+// the niche provides a spare value. Only the default niche is a FunctionalTraits instance, since
+// instances are one-parameter type constructors; pick niches for your types with DefaultNiche.
+template<typename T, typename Niche = typename DefaultNiche<T>::type>
+class CompactOptional final : private detail::CompactStorage<T, Niche>
+{
+    using Storage = detail::CompactStorage<T, Niche>;
+
+public:
+    using value_type = T;
+
+    constexpr CompactOptional() noexcept = default;
+
+    constexpr CompactOptional(std::nullopt_t) noexcept
+    {
+    }
+
+    constexpr CompactOptional(T &&value) noexcept(std::is_nothrow_constructible_v<Storage, T &&>)
+        : Storage(std::move(value))
+    {
+    }
+
+    constexpr CompactOptional(const T &value) noexcept(std::is_nothrow_constructible_v<Storage, const T &>)
+        : Storage(value)
+    {
+    }
+
+    using Storage::has_value;
+
+    constexpr explicit operator bool() const noexcept
+    {
+        return has_value();
+    }
+
+    constexpr T &operator*() & noexcept
+    {
+        return Storage::get();
+    }
+
+    constexpr const T &operator*() const & noexcept
+    {
+        return Storage::get();
+    }
+
+    constexpr T &&operator*() && noexcept
+    {
+        return std::move(Storage::get());
+    }
+
+    constexpr T *operator->() noexcept
+    {
+        return std::addressof(Storage::get());
+    }
+
+    constexpr const T *operator->() const noexcept
+    {
+        return std::addressof(Storage::get());
+    }
+
+    template<typename U>
+    constexpr T value_or(U &&fallback) const &
+    {
+        return has_value() ? Storage::get() : static_cast<T>(std::forward<U>(fallback));
+    }
+
+    template<typename U>
+    constexpr T value_or(U &&fallback) &&
+    {
+        return has_value() ? std::move(Storage::get()) : static_cast<T>(std::forward<U>(fallback));
+    }
+};
+
+namespace detail
+{
+
+template<typename T>
+constexpr bool is_nothrow_compact_v = std::is_nothrow_constructible_v<CompactOptional<std::remove_cvref_t<T>>, T>;
+
+} // namespace detail
+
+template<>
+struct FunctionalTraits<CompactOptional> final
+{
+    template<typename Func, typename Input>
+    static constexpr auto map(Func &&func, CompactOptional<Input> &&input)
+        noexcept(detail::is_nothrow_map_v<Func &&, Input &&> && detail::is_nothrow_compact_v<std::invoke_result_t<Func &&, Input &&>>)
+    {
+        using FuncRet = std::remove_cvref_t<decltype(std::forward<Func>(func)(std::move(*input)))>;
+        if (!input)
+        {
+            return CompactOptional<FuncRet>{};
+        }
+        return CompactOptional<FuncRet>{std::forward<Func>(func)(std::move(*input))};
+    }
+
+    template<typename Func, typename Input>
+    static constexpr auto map(Func &&func, const CompactOptional<Input> &input)
+        noexcept(detail::is_nothrow_map_v<Func &&, const Input &> && detail::is_nothrow_compact_v<std::invoke_result_t<Func &&, const Input &>>)
+    {
+        using FuncRet = std::remove_cvref_t<decltype(std::forward<Func>(func)(*input))>;
+        if (!input)
+        {
+            return CompactOptional<FuncRet>{};
+        }
+        return CompactOptional<FuncRet>{std::forward<Func>(func)(*input)};
+    }
+
+    template<typename Func, typename Input>
+        requires is_instance_v<CompactOptional, Input>
+    static constexpr auto apply(CompactOptional<Func> &&func, Input &&input)
+        noexcept(noexcept(map(std::move(*func), std::forward<Input>(input))))
+    {
+        using FuncRet = std::remove_cvref_t<decltype(map(std::move(*func), std::forward<Input>(input)))>;
+        if (!func)
+        {
+            return FuncRet{};
+        }
+        return map(std::move(*func), std::forward<Input>(input));
+    }
+
+    template<typename Func, typename Input>
+        requires is_instance_v<CompactOptional, Input>
+    static constexpr auto apply(const CompactOptional<Func> &func, Input &&input)
+        noexcept(noexcept(map(*func, std::forward<Input>(input))))
+    {
+        using FuncRet = std::remove_cvref_t<decltype(map(*func, std::forward<Input>(input)))>;
+        if (!func)
+        {
+            return FuncRet{};
+        }
+        return map(*func, std::forward<Input>(input));
+    }
+
+    template<typename Input>
+        requires is_instance_v<CompactOptional, Input>
+    static constexpr auto join(CompactOptional<Input> &&input)
+        noexcept(std::is_nothrow_default_constructible_v<Input> && std::is_nothrow_move_constructible_v<Input>)
+    {
+        if (!input)
+        {
+            return Input{};
+        }
+        return std::move(*input);
+    }
+
+    template<typename Input>
+        requires is_instance_v<CompactOptional, Input>
+    static constexpr auto join(const CompactOptional<Input> &input)
+        noexcept(std::is_nothrow_default_constructible_v<Input> && std::is_nothrow_copy_constructible_v<Input>)
+    {
+        if (!input)
+        {
+            return Input{};
+        }
+        return *input;
+    }
+
+    template<typename InputLeft, typename InputRight>
+        requires std::same_as<CompactOptional<InputLeft>, std::remove_cvref_t<InputRight>>
+    static constexpr auto alternate(CompactOptional<InputLeft> &&lhs, InputRight &&rhs)
+        noexcept(std::is_nothrow_move_constructible_v<CompactOptional<InputLeft>> && std::is_nothrow_constructible_v<CompactOptional<InputLeft>, InputRight &&>)
+    {
+        if (lhs) return std::move(lhs);
+        return CompactOptional<InputLeft>(std::forward<InputRight>(rhs));
+    }
+
+    template<typename InputLeft, typename InputRight>
+        requires std::same_as<CompactOptional<InputLeft>, std::remove_cvref_t<InputRight>>
+    static constexpr auto alternate(const CompactOptional<InputLeft> &lhs, InputRight &&rhs)
+        noexcept(std::is_nothrow_copy_constructible_v<CompactOptional<InputLeft>> && std::is_nothrow_constructible_v<CompactOptional<InputLeft>, InputRight &&>)
+    {
+        if (lhs) return lhs;
+        return CompactOptional<InputLeft>(std::forward<InputRight>(rhs));
+    }
+
+    template<typename Func, typename Input>
+        requires is_instance_v<CompactOptional, Input>
+    static constexpr auto fold_map(Func &&func, Input &&input)
+    {
+        using M = std::remove_cvref_t<std::invoke_result_t<Func &, decltype(*std::forward<Input>(input))>>;
+        if (!input)
+        {
+            return MonoidTraits<M>::empty();
+        }
+        return M(std::invoke(func, *std::forward<Input>(input)));
+    }
+};
+
+} // namespace functional
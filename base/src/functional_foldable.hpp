@@ -0,0 +1,287 @@
+#pragma once
+
+#include <concepts>
+#include <cstddef>
+#include <functional>
+#include <limits>
+#include <optional>
+#include <ranges>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "functional_traits.hpp"
+#include "functional_parallel.hpp"
+
+namespace functional
+{
+
+// A Monoid M provides MonoidTraits<M>::empty() and an associative MonoidTraits<M>::combine(M &&, const M &).
+template<typename M>
+struct MonoidTraits;
+
+template<typename M>
+concept Monoid = requires(M lhs, const M &rhs) {
+    {MonoidTraits<M>::empty()} -> std::same_as<M>;
+    {MonoidTraits<M>::combine(std::move(lhs), rhs)} -> std::same_as<M>;
+};
+
+template<typename T>
+struct Sum final
+{
+    T value;
+};
+
+template<typename T>
+struct Product final
+{
+    T value;
+};
+
+template<typename T>
+struct Min final
+{
+    T value;
+};
+
+template<typename T>
+struct Max final
+{
+    T value;
+};
+
+template<typename T>
+struct MonoidTraits<Sum<T>> final
+{
+    static constexpr Sum<T> empty()
+    {
+        return {T{}};
+    }
+
+    static constexpr Sum<T> combine(Sum<T> &&lhs, const Sum<T> &rhs)
+    {
+        return {std::move(lhs.value) + rhs.value};
+    }
+};
+
+template<typename T>
+struct MonoidTraits<Product<T>> final
+{
+    static constexpr Product<T> empty()
+    {
+        return {T{1}};
+    }
+
+    static constexpr Product<T> combine(Product<T> &&lhs, const Product<T> &rhs)
+    {
+        return {std::move(lhs.value) * rhs.value};
+    }
+};
+
+// Min and Max start from the extremes of numeric_limits, so they are only monoids for types that
+// specialize it; for others (e.g. std::string) the limits would be T{} and fold to a wrong result.
+template<typename T>
+    requires std::numeric_limits<T>::is_specialized
+struct MonoidTraits<Min<T>> final
+{
+    static constexpr Min<T> empty()
+    {
+        return {std::numeric_limits<T>::max()};
+    }
+
+    static constexpr Min<T> combine(Min<T> &&lhs, const Min<T> &rhs)
+    {
+        return rhs.value < lhs.value ? rhs : std::move(lhs);
+    }
+};
+
+template<typename T>
+    requires std::numeric_limits<T>::is_specialized
+struct MonoidTraits<Max<T>> final
+{
+    static constexpr Max<T> empty()
+    {
+        return {std::numeric_limits<T>::lowest()};
+    }
+
+    static constexpr Max<T> combine(Max<T> &&lhs, const Max<T> &rhs)
+    {
+        return lhs.value < rhs.value ? rhs : std::move(lhs);
+    }
+};
+
+template<typename Char>
+struct MonoidTraits<std::basic_string<Char>> final
+{
+    static constexpr std::basic_string<Char> empty()
+    {
+        return {};
+    }
+
+    static constexpr std::basic_string<Char> combine(std::basic_string<Char> &&lhs, const std::basic_string<Char> &rhs)
+    {
+        lhs += rhs;
+        return std::move(lhs);
+    }
+};
+
+template<typename T>
+struct MonoidTraits<std::vector<T>> final
+{
+    static constexpr std::vector<T> empty()
+    {
+        return {};
+    }
+
+    static constexpr std::vector<T> combine(std::vector<T> &&lhs, const std::vector<T> &rhs)
+    {
+        lhs.insert(lhs.end(), rhs.begin(), rhs.end());
+        return std::move(lhs);
+    }
+};
+
+// Random-access ranges of at least this many elements are reduced as a fixed tree of
+// fold_leaf_size blocks. The shape depends only on the size, so results are reproducible
+// for monoids like floating point Sum whatever the number of cores, and ffold_map_par gives
+// the same result as ffold_map.
+inline constexpr std::size_t fold_parallel_threshold = 1 << 15;
+inline constexpr std::size_t fold_leaf_size = 1 << 12;
+
+namespace detail
+{
+
+template<typename Func, typename Range>
+using FoldMapResult = std::remove_cvref_t<std::invoke_result_t<Func &, std::ranges::range_reference_t<Range>>>;
+
+template<template<typename> typename T, typename Func, typename Input>
+concept HasTraitsFoldMap = requires(Func &&func, Input &&input) {
+    FunctionalTraits<T>::fold_map(std::forward<Func>(func), std::forward<Input>(input));
+};
+
+template<typename M, typename Func, typename Range>
+constexpr M fold_map_sequential(Func &func, Range &&range, std::size_t begin, std::size_t end)
+{
+    M result = MonoidTraits<M>::empty();
+    for (std::size_t idx = begin; idx < end; ++idx)
+    {
+        result = MonoidTraits<M>::combine(std::move(result), std::invoke(func, range[idx]));
+    }
+    return result;
+}
+
+// Leaves run on ThreadPool::global() when Parallel is set, on the caller otherwise.
+template<bool Parallel, typename M, typename Func, typename Range>
+M fold_map_tree(Func &func, Range &&range)
+{
+    const std::size_t size = static_cast<std::size_t>(std::ranges::size(range));
+    const std::size_t leaf_count = (size + fold_leaf_size - 1) / fold_leaf_size;
+    std::vector<M> partials;
+    partials.reserve(leaf_count);
+    for (std::size_t leaf = 0; leaf < leaf_count; ++leaf)
+    {
+        partials.push_back(MonoidTraits<M>::empty());
+    }
+    const auto fold_leaf = [&func, &range, &partials, size] (std::size_t leaf) {
+        const std::size_t begin = leaf * fold_leaf_size;
+        partials[leaf] = fold_map_sequential<M>(func, range, begin, std::min(begin + fold_leaf_size, size));
+    };
+    if constexpr (Parallel)
+    {
+        parallel_for(leaf_count, fold_leaf);
+    }
+    else
+    {
+        for (std::size_t leaf = 0; leaf < leaf_count; ++leaf)
+        {
+            fold_leaf(leaf);
+        }
+    }
+    for (std::size_t stride = 1; stride < leaf_count; stride *= 2)
+    {
+        for (std::size_t idx = 0; idx + stride < leaf_count; idx += 2 * stride)
+        {
+            partials[idx] = MonoidTraits<M>::combine(std::move(partials[idx]), partials[idx + stride]);
+        }
+    }
+    return std::move(partials.front());
+}
+
+template<bool Parallel = false, typename Func, typename Range>
+    requires Monoid<FoldMapResult<Func, Range>>
+constexpr auto fold_map_range(Func &&func, Range &&range)
+{
+    using M = FoldMapResult<Func, Range>;
+    if constexpr (std::ranges::random_access_range<Range> && std::ranges::sized_range<Range>)
+    {
+        if (!std::is_constant_evaluated() && std::ranges::size(range) >= fold_parallel_threshold)
+        {
+            return fold_map_tree<Parallel, M>(func, range);
+        }
+    }
+    M result = MonoidTraits<M>::empty();
+    for (auto &&element : range)
+    {
+        result = MonoidTraits<M>::combine(std::move(result), std::invoke(func, std::forward<decltype(element)>(element)));
+    }
+    return result;
+}
+
+template<template<typename> typename T, typename Value, typename Func, typename Input>
+    requires HasTraitsFoldMap<T, Func, Input>
+constexpr auto fold_map_instance(T<Value> *, Func &&func, Input &&input)
+{
+    return FunctionalTraits<T>::fold_map(std::forward<Func>(func), std::forward<Input>(input));
+}
+
+struct FoldProbe final
+{
+    constexpr Sum<int> operator()(int value) const noexcept
+    {
+        return {value};
+    }
+};
+
+} // namespace detail
+
+// Maps every element to a Monoid and combines the results left to right. Works on any input
+// range and on instances that provide FunctionalTraits<T>::fold_map (e.g. std::optional).
+template<typename Func, typename Input>
+constexpr auto ffold_map(Func &&func, Input &&input)
+{
+    if constexpr (std::ranges::input_range<Input>)
+    {
+        return detail::fold_map_range(std::forward<Func>(func), std::forward<Input>(input));
+    }
+    else
+    {
+        return detail::fold_map_instance(static_cast<std::remove_cvref_t<Input> *>(nullptr), std::forward<Func>(func), std::forward<Input>(input));
+    }
+}
+
+// ffold_map with the blocks of large random-access ranges folded on ThreadPool::global(). func is
+// called concurrently through a const reference, so it must be safe to share between threads;
+// the result is the same as ffold_map's.
+template<typename Func, typename Range>
+    requires std::ranges::random_access_range<Range> && std::ranges::sized_range<Range>
+        && std::is_invocable_v<const Func &, std::ranges::range_reference_t<Range>>
+auto ffold_map_par(const Func &func, Range &&range)
+{
+    return detail::fold_map_range<true>(func, std::forward<Range>(range));
+}
+
+template<typename Input>
+constexpr auto ffold(Input &&input)
+{
+    constexpr auto forward_element = [] <typename Element> (Element &&element) -> std::remove_cvref_t<Element> {
+        return std::forward<Element>(element);
+    };
+    return ffold_map(forward_element, std::forward<Input>(input));
+}
+
+template<template<typename> typename T>
+concept Foldable = requires(const T<int> &t) {
+    {ffold_map(detail::FoldProbe{}, t)} -> std::same_as<Sum<int>>;
+};
+
+} // namespace functional
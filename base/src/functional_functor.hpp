@@ -1,5 +1,8 @@
 #pragma once
 
+#include <type_traits>
+#include <utility>
+
 #include "functional_traits.hpp"
 
 namespace functional
@@ -49,24 +52,51 @@ struct MoveOnlyFunctionObject final
     }
 };
 
+// True when calling func on arg and moving the result into place cannot throw.
+template<typename Func, typename Arg>
+constexpr bool is_nothrow_map_v = std::is_nothrow_invocable_v<Func, Arg>
+    && std::is_nothrow_move_constructible_v<std::remove_cvref_t<std::invoke_result_t<Func, Arg>>>;
+
+template<template<typename> typename T, typename Input>
+concept HasTraitsPure = requires(Input &&input) {
+    FunctionalTraits<T>::pure(std::forward<Input>(input));
+};
+
 } // namespace detail
 
 template<template<typename> typename T, typename Input>
-constexpr auto fpure(Input &&input)
+    requires detail::HasTraitsPure<T, Input>
+#define CALL_TEXT FunctionalTraits<T>::pure(std::forward<Input>(input))
+constexpr auto fpure(Input &&input) noexcept(noexcept(CALL_TEXT))
+{
+    return CALL_TEXT;
+#undef CALL_TEXT
+}
+
+template<template<typename> typename T, typename Input>
+    requires (!detail::HasTraitsPure<T, Input>)
+#define CALL_TEXT T<std::remove_cvref_t<Input>>{std::forward<Input>(input)}
+constexpr auto fpure(Input &&input) noexcept(noexcept(CALL_TEXT))
 {
-    return T<std::remove_cvref_t<Input>>{std::forward<Input>(input)};
+    return CALL_TEXT;
+#undef CALL_TEXT
 }
 
 template<template<typename> typename T, typename Func, typename Input>
-constexpr auto fmap(Func &&func, T<Input> &&input)
+#define CALL_TEXT FunctionalTraits<T>::map(std::forward<Func>(func), std::move(input))
+constexpr auto fmap(Func &&func, T<Input> &&input) noexcept(noexcept(CALL_TEXT))
 {
-    return FunctionalTraits<T>::map(std::forward<Func>(func), std::move(input));
+    return CALL_TEXT;
+#undef CALL_TEXT
 }
 
 template<template<typename> typename T, typename Func, typename Input>
-constexpr auto fmap(Func &&func, const T<Input> &input)
+    requires (!SingleShot<T>)
+#define CALL_TEXT FunctionalTraits<T>::map(std::forward<Func>(func), input)
+constexpr auto fmap(Func &&func, const T<Input> &input) noexcept(noexcept(CALL_TEXT))
 {
-    return FunctionalTraits<T>::map(std::forward<Func>(func), input);
+    return CALL_TEXT;
+#undef CALL_TEXT
 }
 
 template<template<typename> typename T>
@@ -7,16 +7,20 @@ namespace functional
 
 template<template<typename> typename T, typename Input>
     requires is_instance_v<T, Input>
-constexpr auto fjoin(T<Input> &&input)
+#define CALL_TEXT FunctionalTraits<T>::join(std::move(input))
+constexpr auto fjoin(T<Input> &&input) noexcept(noexcept(CALL_TEXT))
 {
-    return FunctionalTraits<T>::join(std::move(input));
+    return CALL_TEXT;
+#undef CALL_TEXT
 }
 
 template<template<typename> typename T, typename Input>
     requires is_instance_v<T, Input>
-constexpr auto fjoin(const T<Input> &input)
+#define CALL_TEXT FunctionalTraits<T>::join(input)
+constexpr auto fjoin(const T<Input> &input) noexcept(noexcept(CALL_TEXT))
 {
-    return FunctionalTraits<T>::join(input);
+    return CALL_TEXT;
+#undef CALL_TEXT
 }
 
 template<template<typename> typename T>
@@ -26,22 +30,28 @@ concept Monad = Applicative<T> && requires(T<T<detail::MoveOnlyData>> t) {
 
 template<template<typename> typename T, typename Func, typename Input>
     requires is_instance_v<T, decltype(fmap(std::declval<Func>(), std::declval<T<Input> &&>()))>
-constexpr auto fbind(Func &&func, T<Input> &&input)
+#define CALL_TEXT fjoin(fmap(std::forward<Func>(func), std::move(input)))
+constexpr auto fbind(Func &&func, T<Input> &&input) noexcept(noexcept(CALL_TEXT))
 {
-    return fjoin(fmap(std::forward<Func>(func), std::move(input)));
+    return CALL_TEXT;
+#undef CALL_TEXT
 }
 
 template<template<typename> typename T, typename Func, typename Input>
     requires is_instance_v<T, decltype(fmap(std::declval<Func>(), std::declval<const T<Input> &>()))>
-constexpr auto fbind(Func &&func, const T<Input> &input)
+#define CALL_TEXT fjoin(fmap(std::forward<Func>(func), input))
+constexpr auto fbind(Func &&func, const T<Input> &input) noexcept(noexcept(CALL_TEXT))
 {
-    return fjoin(fmap(std::forward<Func>(func), input));
+    return CALL_TEXT;
+#undef CALL_TEXT
 }
 
 template<typename T, typename Func>
-constexpr auto operator>>(T &&value, Func &&func)
+#define CALL_TEXT fbind(std::forward<Func>(func), std::forward<T>(value))
+constexpr auto operator>>(T &&value, Func &&func) noexcept(noexcept(CALL_TEXT))
 {
-    return fbind(std::forward<Func>(func), std::forward<T>(value));
+    return CALL_TEXT;
+#undef CALL_TEXT
 }
 
 } // namespace functional
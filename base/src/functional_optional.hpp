@@ -1,8 +1,11 @@
 #pragma once
 
 #include <optional>
+#include <vector>
 
 #include "functional_monad.hpp"
+#include "functional_traverse.hpp"
+#include "functional_foldable.hpp"
 
 namespace functional
 {
@@ -11,7 +14,7 @@ template<>
 struct FunctionalTraits<std::optional> final
 {
     template<typename Func, typename Input>
-    static constexpr auto map(Func &&func, std::optional<Input> &&input)
+    static constexpr auto map(Func &&func, std::optional<Input> &&input) noexcept(detail::is_nothrow_map_v<Func &&, Input &&>)
     {
         using functional::fpure;
         using FuncRet = std::remove_cvref_t<decltype(std::forward<Func>(func)(std::move(*input)))>;
@@ -23,7 +26,7 @@ struct FunctionalTraits<std::optional> final
     }
 
     template<typename Func, typename Input>
-    static constexpr auto map(Func &&func, const std::optional<Input> &input)
+    static constexpr auto map(Func &&func, const std::optional<Input> &input) noexcept(detail::is_nothrow_map_v<Func &&, const Input &>)
     {
         using functional::fpure;
         using FuncRet = std::remove_cvref_t<decltype(std::forward<Func>(func)(*input))>;
@@ -37,6 +40,7 @@ struct FunctionalTraits<std::optional> final
     template<typename Func, typename Input>
         requires is_instance_v<std::optional, Input>
     static constexpr auto apply(std::optional<Func> &&func, Input &&input)
+        noexcept(noexcept(map(std::move(*func), std::forward<Input>(input))))
     {
         using FuncRet = std::remove_cvref_t<decltype(map(std::move(*func), std::forward<Input>(input)))>;
         if (!func)
@@ -49,6 +53,7 @@ struct FunctionalTraits<std::optional> final
     template<typename Func, typename Input>
         requires is_instance_v<std::optional, Input>
     static constexpr auto apply(const std::optional<Func> &func, Input &&input)
+        noexcept(noexcept(map(*func, std::forward<Input>(input))))
     {
         using FuncRet = std::remove_cvref_t<decltype(map(*func, std::forward<Input>(input)))>;
         if (!func)
@@ -61,6 +66,7 @@ struct FunctionalTraits<std::optional> final
     template<typename Input>
         requires is_instance_v<std::optional, Input>
     static constexpr auto join(std::optional<Input> &&input)
+        noexcept(std::is_nothrow_default_constructible_v<Input> && std::is_nothrow_move_constructible_v<Input>)
     {
         if (!input)
         {
@@ -72,6 +78,7 @@ struct FunctionalTraits<std::optional> final
     template<typename Input>
         requires is_instance_v<std::optional, Input>
     static constexpr auto join(const std::optional<Input> &input)
+        noexcept(std::is_nothrow_default_constructible_v<Input> && std::is_nothrow_copy_constructible_v<Input>)
     {
         if (!input)
         {
@@ -83,6 +90,7 @@ struct FunctionalTraits<std::optional> final
     template<typename InputLeft, typename InputRight>
         requires std::same_as<std::optional<InputLeft>, std::remove_cvref_t<InputRight>>
     static constexpr auto alternate(std::optional<InputLeft> &&lhs, InputRight &&rhs)
+        noexcept(std::is_nothrow_move_constructible_v<std::optional<InputLeft>> && std::is_nothrow_constructible_v<std::optional<InputLeft>, InputRight &&>)
     {
         if (lhs) return std::move(lhs);
         return std::forward<InputRight>(rhs);
@@ -91,10 +99,42 @@ struct FunctionalTraits<std::optional> final
     template<typename InputLeft, typename InputRight>
         requires std::same_as<std::optional<InputLeft>, std::remove_cvref_t<InputRight>>
     static constexpr auto alternate(const std::optional<InputLeft> &lhs, InputRight &&rhs)
+        noexcept(std::is_nothrow_copy_constructible_v<std::optional<InputLeft>> && std::is_nothrow_constructible_v<std::optional<InputLeft>, InputRight &&>)
     {
         if (lhs) return lhs;
         return std::forward<InputRight>(rhs);
     }
+
+    template<typename Func, typename Range>
+    static constexpr auto traverse(Func &&func, Range &&range)
+    {
+        using Wrapped = std::remove_cvref_t<std::invoke_result_t<Func &, std::ranges::range_reference_t<Range>>>;
+        using Value = typename Wrapped::value_type;
+        std::vector<Value> result;
+        result.reserve(detail::reserve_hint(range));
+        for (auto &&element : range)
+        {
+            auto &&wrapped = std::invoke(func, detail::forward_range_element<Range>(element));
+            if (!wrapped)
+            {
+                return std::optional<std::vector<Value>>{};
+            }
+            result.push_back(*std::forward<decltype(wrapped)>(wrapped));
+        }
+        return std::optional<std::vector<Value>>{std::move(result)};
+    }
+
+    template<typename Func, typename Input>
+        requires is_instance_v<std::optional, Input>
+    static constexpr auto fold_map(Func &&func, Input &&input)
+    {
+        using M = std::remove_cvref_t<std::invoke_result_t<Func &, decltype(*std::forward<Input>(input))>>;
+        if (!input)
+        {
+            return MonoidTraits<M>::empty();
+        }
+        return M(std::invoke(func, *std::forward<Input>(input)));
+    }
 };
 
 } // namespace functional
@@ -0,0 +1,134 @@
+#pragma once
+
+#include <algorithm>
+#include <coroutine>
+#include <cstddef>
+#include <exception>
+#include <latch>
+#include <mutex>
+#include <utility>
+
+#include "functional_thread_pool.hpp"
+
+namespace functional
+{
+
+namespace detail
+{
+
+// Fire-and-forget coroutine: posted to a ThreadPool and destroyed when it finishes.
+struct PoolJob final
+{
+    struct promise_type final
+    {
+        PoolJob get_return_object() noexcept
+        {
+            return PoolJob{std::coroutine_handle<promise_type>::from_promise(*this)};
+        }
+
+        std::suspend_always initial_suspend() noexcept
+        {
+            return {};
+        }
+
+        std::suspend_never final_suspend() noexcept
+        {
+            return {};
+        }
+
+        void return_void() noexcept
+        {
+        }
+
+        void unhandled_exception() noexcept
+        {
+            std::terminate();
+        }
+    };
+
+    std::coroutine_handle<promise_type> handle;
+};
+
+template<typename RunChunk>
+PoolJob pool_chunk(const RunChunk &run_chunk, std::size_t begin, std::size_t end, std::latch &done)
+{
+    run_chunk(begin, end);
+    done.count_down();
+    co_return;
+}
+
+// Splits [0, count) into one contiguous chunk per worker of pool and calls
+// body(idx) for every index. The calling thread processes the last chunk itself and waits for the
+// others; the first exception thrown is rethrown. Called from a pool worker it runs inline, so a
+// nested parallel_for cannot block every worker on work that only those workers could run.
+template<typename Body>
+void parallel_for(std::size_t count, const Body &body, ThreadPool &pool = ThreadPool::global())
+{
+    const std::size_t workers = std::min(pool.worker_count(), count);
+    if (workers <= 1 || pool.is_worker_thread())
+    {
+        for (std::size_t idx = 0; idx < count; ++idx)
+        {
+            body(idx);
+        }
+        return;
+    }
+
+    std::exception_ptr first_exception;
+    std::mutex exception_mutex;
+    const auto run_chunk = [&] (std::size_t begin, std::size_t end) noexcept {
+        try
+        {
+            for (std::size_t idx = begin; idx < end; ++idx)
+            {
+                body(idx);
+            }
+        }
+        catch (...)
+        {
+            std::lock_guard lock{exception_mutex};
+            if (!first_exception)
+            {
+                first_exception = std::current_exception();
+            }
+        }
+    };
+
+    const std::size_t chunk_size = (count + workers - 1) / workers;
+    const std::size_t posted = (count - 1) / chunk_size;
+    std::latch done{static_cast<std::ptrdiff_t>(posted)};
+    std::size_t begin = 0;
+    for (; begin + chunk_size < count; begin += chunk_size)
+    {
+        // A chunk that cannot be handed to the pool runs here, so the latch still reaches zero.
+        try
+        {
+            const PoolJob job = pool_chunk(run_chunk, begin, begin + chunk_size, done);
+            try
+            {
+                pool.post(job.handle);
+            }
+            catch (...)
+            {
+                job.handle.destroy();
+                throw;
+            }
+        }
+        catch (...)
+        {
+            run_chunk(begin, begin + chunk_size);
+            done.count_down();
+        }
+    }
+    run_chunk(begin, count);
+    done.wait();
+
+    if (first_exception)
+    {
+        std::rethrow_exception(first_exception);
+    }
+}
+
+} // namespace detail
+
+} // namespace functional
@@ -1,10 +1,34 @@
 #pragma once
 
+#include <cstddef>
 #include <functional>
+#include <type_traits>
+#include <utility>
 
 namespace functional
 {
 
+namespace detail
+{
+
+template<std::size_t Idx, typename T>
+struct SavedArg
+{
+    T value;
+};
+
+// Flat replacement for std::tuple: every leaf is instantiated once per (index, type) and shared
+// by all argument lists, so saving N arguments one by one no longer costs O(N^2) instantiations.
+template<typename Indices, typename ...Args>
+struct SavedArgs;
+
+template<std::size_t ...Idx, typename ...Args>
+struct SavedArgs<std::index_sequence<Idx...>, Args...> : SavedArg<Idx, Args>...
+{
+};
+
+} // namespace detail
+
 template<typename T, typename ...Args>
 struct PartiallyApplicable : T
 {
@@ -14,60 +38,53 @@ struct PartiallyApplicable : T
     {
     }
 
+    // One overload per value category; whether the call completes or saves more arguments is
+    // decided by a single is_invocable check instead of by competing constrained overloads.
     template<typename ...NonSavedArgs>
-        requires std::is_invocable_v<const T &, const Args &..., NonSavedArgs &&...>
-    constexpr auto operator()(NonSavedArgs &&...args) const &
-    {
-        return unpack_tuple([this, &args...] <typename ...TupleArgs> (TupleArgs &&...tuple_args) {
-            return std::invoke(static_cast<const T &>(*this), std::forward<TupleArgs>(tuple_args)..., std::forward<NonSavedArgs>(args)...);
-        }, std::index_sequence_for<Args...>{});
-    }
-
-    template<typename ...NonSavedArgs>
-        requires std::is_invocable_v<T &, Args &..., NonSavedArgs &&...>
-    constexpr auto operator()(NonSavedArgs &&...args) &
-    {
-        return unpack_tuple([this, &args...] <typename ...TupleArgs> (TupleArgs &&...tuple_args) {
-            return std::invoke(static_cast<T &>(*this), std::forward<TupleArgs>(tuple_args)..., std::forward<NonSavedArgs>(args)...);
-        }, std::index_sequence_for<Args...>{});
-    }
-
-    template<typename ...NonSavedArgs>
-        requires std::is_invocable_v<T &&, Args &&..., NonSavedArgs &&...>
-    constexpr auto operator()(NonSavedArgs &&...args) &&
-    {
-        return unpack_tuple([this, &args...] <typename ...TupleArgs> (TupleArgs &&...tuple_args) {
-            return std::invoke(static_cast<T &&>(*this), std::forward<TupleArgs>(tuple_args)..., std::forward<NonSavedArgs>(args)...);
-        }, std::index_sequence_for<Args...>{});
-    }
-
-    template<typename ...NonSavedArgs>
-        requires (!std::is_invocable_v<const T &, const Args &..., NonSavedArgs &&...>)
     constexpr auto operator()(NonSavedArgs &&...args) const &
     {
-        using RetType = PartiallyApplicable<T, Args..., std::remove_cvref_t<NonSavedArgs>...>;
         return unpack_tuple([this, &args...] <typename ...TupleArgs> (TupleArgs &&...tuple_args) {
-            return RetType{static_cast<const T &>(*this), std::forward<TupleArgs>(tuple_args)..., std::forward<NonSavedArgs>(args)...};
+            if constexpr (std::is_invocable_v<const T &, const Args &..., NonSavedArgs &&...>)
+            {
+                return std::invoke(static_cast<const T &>(*this), std::forward<TupleArgs>(tuple_args)..., std::forward<NonSavedArgs>(args)...);
+            }
+            else
+            {
+                using RetType = PartiallyApplicable<T, Args..., std::remove_cvref_t<NonSavedArgs>...>;
+                return RetType{static_cast<const T &>(*this), std::forward<TupleArgs>(tuple_args)..., std::forward<NonSavedArgs>(args)...};
+            }
         }, std::index_sequence_for<Args...>{});
     }
 
     template<typename ...NonSavedArgs>
-        requires (!std::is_invocable_v<T &, Args &..., NonSavedArgs &&...>)
     constexpr auto operator()(NonSavedArgs &&...args) &
     {
-        using RetType = PartiallyApplicable<T, Args..., std::remove_cvref_t<NonSavedArgs>...>;
         return unpack_tuple([this, &args...] <typename ...TupleArgs> (TupleArgs &&...tuple_args) {
-            return RetType{static_cast<T &>(*this), std::forward<TupleArgs>(tuple_args)..., std::forward<NonSavedArgs>(args)...};
+            if constexpr (std::is_invocable_v<T &, Args &..., NonSavedArgs &&...>)
+            {
+                return std::invoke(static_cast<T &>(*this), std::forward<TupleArgs>(tuple_args)..., std::forward<NonSavedArgs>(args)...);
+            }
+            else
+            {
+                using RetType = PartiallyApplicable<T, Args..., std::remove_cvref_t<NonSavedArgs>...>;
+                return RetType{static_cast<T &>(*this), std::forward<TupleArgs>(tuple_args)..., std::forward<NonSavedArgs>(args)...};
+            }
         }, std::index_sequence_for<Args...>{});
     }
 
     template<typename ...NonSavedArgs>
-        requires (!std::is_invocable_v<T &&, Args &&..., NonSavedArgs &&...>)
     constexpr auto operator()(NonSavedArgs &&...args) &&
     {
-        using RetType = PartiallyApplicable<T, Args..., std::remove_cvref_t<NonSavedArgs>...>;
         return unpack_tuple([this, &args...] <typename ...TupleArgs> (TupleArgs &&...tuple_args) {
-            return RetType{static_cast<T &&>(*this), std::forward<TupleArgs>(tuple_args)..., std::forward<NonSavedArgs>(args)...};
+            if constexpr (std::is_invocable_v<T &&, Args &&..., NonSavedArgs &&...>)
+            {
+                return std::invoke(static_cast<T &&>(*this), std::forward<TupleArgs>(tuple_args)..., std::forward<NonSavedArgs>(args)...);
+            }
+            else
+            {
+                using RetType = PartiallyApplicable<T, Args..., std::remove_cvref_t<NonSavedArgs>...>;
+                return RetType{static_cast<T &&>(*this), std::forward<TupleArgs>(tuple_args)..., std::forward<NonSavedArgs>(args)...};
+            }
         }, std::index_sequence_for<Args...>{});
     }
 
@@ -75,23 +92,23 @@ private:
     template<typename Callable, size_t ...Idx>
     constexpr auto unpack_tuple(Callable &&callable, std::index_sequence<Idx...>) const &
     {
-        return std::forward<Callable>(callable)(std::get<Idx>(saved_args_)...);
+        return std::forward<Callable>(callable)(static_cast<const detail::SavedArg<Idx, Args> &>(saved_args_).value...);
     }
 
     template<typename Callable, size_t ...Idx>
     constexpr auto unpack_tuple(Callable &&callable, std::index_sequence<Idx...>) &
     {
-        return std::forward<Callable>(callable)(std::get<Idx>(saved_args_)...);
+        return std::forward<Callable>(callable)(static_cast<detail::SavedArg<Idx, Args> &>(saved_args_).value...);
     }
 
     template<typename Callable, size_t ...Idx>
     constexpr auto unpack_tuple(Callable &&callable, std::index_sequence<Idx...>) &&
     {
-        return std::forward<Callable>(callable)(std::get<Idx>(std::move(saved_args_))...);
+        return std::forward<Callable>(callable)(std::move(static_cast<detail::SavedArg<Idx, Args> &>(saved_args_).value)...);
     }
 
 private:
-    std::tuple<Args...> saved_args_;
+    detail::SavedArgs<std::index_sequence_for<Args...>, Args...> saved_args_;
 };
 
 template<typename T>
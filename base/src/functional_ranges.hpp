@@ -0,0 +1,137 @@
+#pragma once
+
+#include <ranges>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "functional_monad.hpp"
+
+namespace functional
+{
+
+// Lazy Functor/Monad over std::ranges views. Unlike the other instances the template parameter is
+// the underlying view type, not the element type: fmap stacks a transform_view, fbind a
+// transform_view | join_view, and nothing is stored until the range is materialized.
+template<typename View>
+struct LazyRange final : std::ranges::view_interface<LazyRange<View>>
+{
+    constexpr LazyRange()
+        requires std::default_initializable<View>
+    = default;
+
+    explicit constexpr LazyRange(View view_)
+        : view(std::move(view_))
+    {
+    }
+
+    constexpr auto begin()
+    {
+        return std::ranges::begin(view);
+    }
+
+    constexpr auto end()
+    {
+        return std::ranges::end(view);
+    }
+
+    constexpr auto begin() const
+        requires std::ranges::range<const View>
+    {
+        return std::ranges::begin(view);
+    }
+
+    constexpr auto end() const
+        requires std::ranges::range<const View>
+    {
+        return std::ranges::end(view);
+    }
+
+    View view;
+};
+
+template<std::ranges::viewable_range Range>
+constexpr auto lazy(Range &&range)
+{
+    return LazyRange<std::views::all_t<Range>>{std::views::all(std::forward<Range>(range))};
+}
+
+template<typename View>
+constexpr auto materialize(LazyRange<View> input)
+{
+    std::vector<std::remove_cvref_t<std::ranges::range_reference_t<View>>> result;
+    if constexpr (std::ranges::sized_range<View>)
+    {
+        result.reserve(std::ranges::size(input.view));
+    }
+    for (auto &&value : input.view)
+    {
+        result.push_back(std::forward<decltype(value)>(value));
+    }
+    return result;
+}
+
+template<>
+struct FunctionalTraits<LazyRange> final
+{
+    template<typename Input>
+    static constexpr auto pure(Input &&input)
+    {
+        using SingleView = std::ranges::single_view<std::remove_cvref_t<Input>>;
+        return LazyRange<SingleView>{SingleView{std::forward<Input>(input)}};
+    }
+
+    template<typename Func, typename View>
+    static constexpr auto map(Func &&func, LazyRange<View> &&input)
+    {
+        return LazyRange{std::views::transform(std::move(input.view), std::forward<Func>(func))};
+    }
+
+    template<typename Func, typename View>
+    static constexpr auto map(Func &&func, const LazyRange<View> &input)
+    {
+        return LazyRange{std::views::transform(input.view, std::forward<Func>(func))};
+    }
+
+    // Every function is applied to every value, functions in the outer loop.
+    template<typename FuncView, typename Input>
+        requires is_instance_v<LazyRange, Input>
+    static constexpr auto apply(LazyRange<FuncView> func, Input &&input)
+    {
+        // Function-call form: functional::operator| would hijack the pipe syntax in this namespace.
+        auto values = std::forward<Input>(input).view;
+        return LazyRange{std::views::join(std::views::transform(
+                std::move(func.view),
+                [values = std::move(values)] (const auto &wrapped_func) {
+                    return std::views::transform(values, wrapped_func);
+                }))};
+    }
+
+    template<typename View>
+        requires is_instance_v<LazyRange, std::ranges::range_value_t<View>>
+    static constexpr auto join(LazyRange<View> input)
+    {
+        return LazyRange{std::views::join(std::move(input.view))};
+    }
+};
+
+// The nested LazyRange lives in the element type, so the generic fjoin constraint on T<T<...>>
+// does not apply; these overloads make fbind and operator>> work through ADL.
+template<typename View>
+    requires is_instance_v<LazyRange, std::ranges::range_value_t<View>>
+constexpr auto fjoin(LazyRange<View> &&input)
+{
+    return FunctionalTraits<LazyRange>::join(std::move(input));
+}
+
+template<typename View>
+    requires is_instance_v<LazyRange, std::ranges::range_value_t<View>>
+constexpr auto fjoin(const LazyRange<View> &input)
+{
+    return FunctionalTraits<LazyRange>::join(input);
+}
+
+} // namespace functional
+
+template<typename View>
+inline constexpr bool std::ranges::enable_borrowed_range<functional::LazyRange<View>> = std::ranges::enable_borrowed_range<View>;
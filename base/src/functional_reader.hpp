@@ -0,0 +1,154 @@
+#pragma once
+
+#include <functional>
+#include <type_traits>
+#include <utility>
+
+#include "functional_monad.hpp"
+
+namespace functional
+{
+
+// Computation that reads an environment: Reader<Func> wraps a callable `const Env & -> T`. As with
+// LazyRange the template parameter is the callable, not the value type, so fmap/fapply/fbind nest
+// closures by value and a whole chain inlines into one call; nothing is type-erased or allocated.
+// The environment type is only fixed when the reader is run, so one chain works for any Env that
+// supports the operations it performs.
+template<typename Func>
+struct Reader final
+{
+    template<typename Env>
+    constexpr decltype(auto) run(const Env &env) const &
+    {
+        return std::invoke(func, env);
+    }
+
+    template<typename Env>
+    constexpr decltype(auto) run(const Env &env) &&
+    {
+        return std::invoke(std::move(func), env);
+    }
+
+    Func func;
+};
+
+template<typename Func>
+Reader(Func) -> Reader<Func>;
+
+// Projects a value out of the environment, e.g. `asks(&Options::strict)`.
+template<typename Func>
+constexpr auto asks(Func &&func)
+{
+    return Reader{[func = std::forward<Func>(func)] (const auto &env) {
+        return std::invoke(func, env);
+    }};
+}
+
+// Returns a copy of the whole environment; prefer asks() for large environments.
+constexpr auto ask()
+{
+    return Reader{[] <typename Env> (const Env &env) -> Env {
+        return env;
+    }};
+}
+
+// Runs reader in an environment derived from the current one.
+template<typename Func, typename ReaderFunc>
+constexpr auto local(Func &&func, Reader<ReaderFunc> reader)
+{
+    return Reader{[func = std::forward<Func>(func), inner = std::move(reader.func)] (const auto &env) {
+        return std::invoke(inner, std::invoke(func, env));
+    }};
+}
+
+template<>
+struct FunctionalTraits<Reader> final
+{
+    template<typename Input>
+    static constexpr auto pure(Input &&input)
+    {
+        return Reader{[value = std::forward<Input>(input)] (const auto &) {
+            return value;
+        }};
+    }
+
+    template<typename Func, typename Input>
+    static constexpr auto map(Func &&func, Reader<Input> &&input)
+    {
+        return map_impl(std::forward<Func>(func), std::move(input.func));
+    }
+
+    template<typename Func, typename Input>
+    static constexpr auto map(Func &&func, const Reader<Input> &input)
+    {
+        return map_impl(std::forward<Func>(func), input.func);
+    }
+
+    template<typename Func, typename Input>
+        requires is_instance_v<Reader, Input>
+    static constexpr auto apply(Reader<Func> &&func, Input &&input)
+    {
+        return apply_impl(std::move(func.func), std::forward<Input>(input).func);
+    }
+
+    template<typename Func, typename Input>
+        requires is_instance_v<Reader, Input>
+    static constexpr auto apply(const Reader<Func> &func, Input &&input)
+    {
+        return apply_impl(func.func, std::forward<Input>(input).func);
+    }
+
+    // The outer reader yields a reader, which is run in the same environment.
+    template<typename Input>
+    static constexpr auto join(Reader<Input> &&input)
+    {
+        return join_impl(std::move(input.func));
+    }
+
+    template<typename Input>
+    static constexpr auto join(const Reader<Input> &input)
+    {
+        return join_impl(input.func);
+    }
+
+private:
+    template<typename Func, typename InputFunc>
+    static constexpr auto map_impl(Func &&func, InputFunc &&input)
+    {
+        return Reader{[func = std::forward<Func>(func), input = std::forward<InputFunc>(input)] (const auto &env) {
+            return std::invoke(func, std::invoke(input, env));
+        }};
+    }
+
+    template<typename Func, typename InputFunc>
+    static constexpr auto apply_impl(Func &&func, InputFunc &&input)
+    {
+        return Reader{[func = std::forward<Func>(func), input = std::forward<InputFunc>(input)] (const auto &env) {
+            return std::invoke(std::invoke(func, env), std::invoke(input, env));
+        }};
+    }
+
+    template<typename InputFunc>
+    static constexpr auto join_impl(InputFunc &&input)
+    {
+        return Reader{[input = std::forward<InputFunc>(input)] (const auto &env) {
+            return std::invoke(input, env).run(env);
+        }};
+    }
+};
+
+// The nested Reader is only known once the environment is, so the generic fjoin constraint on
+// T<T<...>> does not apply; these overloads make fbind and operator>> work through ADL.
+template<typename Func>
+constexpr auto fjoin(Reader<Func> &&input)
+{
+    return FunctionalTraits<Reader>::join(std::move(input));
+}
+
+template<typename Func>
+constexpr auto fjoin(const Reader<Func> &input)
+{
+    return FunctionalTraits<Reader>::join(input);
+}
+
+} // namespace functional
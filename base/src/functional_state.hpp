@@ -0,0 +1,175 @@
+#pragma once
+
+#include <functional>
+#include <type_traits>
+#include <utility>
+#include <variant>
+
+#include "functional_monad.hpp"
+
+namespace functional
+{
+
+// Computation that threads a state: State<Func> wraps a callable `S -> std::pair<T, S>`. Like
+// Reader, the template parameter is the callable, so a chain of fbinds is one nested closure that
+// the compiler inlines into straight-line code, and S is only fixed when the computation is run.
+template<typename Func>
+struct State final
+{
+    template<typename S>
+    constexpr auto run(S state) const &
+    {
+        return std::invoke(func, std::move(state));
+    }
+
+    template<typename S>
+    constexpr auto run(S state) &&
+    {
+        return std::invoke(std::move(func), std::move(state));
+    }
+
+    Func func;
+};
+
+template<typename Func>
+State(Func) -> State<Func>;
+
+constexpr auto get_state()
+{
+    return State{[] <typename S> (S state) {
+        S copy = state;
+        return std::pair<S, S>{std::move(copy), std::move(state)};
+    }};
+}
+
+template<typename S>
+constexpr auto put_state(S &&value)
+{
+    return State{[value = std::forward<S>(value)] (auto &&) {
+        return std::pair{std::monostate{}, value};
+    }};
+}
+
+template<typename Func>
+constexpr auto modify_state(Func &&func)
+{
+    return State{[func = std::forward<Func>(func)] <typename S> (S state) {
+        return std::pair<std::monostate, S>{std::monostate{}, std::invoke(func, std::move(state))};
+    }};
+}
+
+template<typename Func, typename S>
+constexpr auto run_state(State<Func> computation, S &&state)
+{
+    return std::move(computation).run(std::forward<S>(state));
+}
+
+template<typename Func, typename S>
+constexpr auto eval_state(State<Func> computation, S &&state)
+{
+    return std::move(computation).run(std::forward<S>(state)).first;
+}
+
+template<typename Func, typename S>
+constexpr auto exec_state(State<Func> computation, S &&state)
+{
+    return std::move(computation).run(std::forward<S>(state)).second;
+}
+
+template<>
+struct FunctionalTraits<State> final
+{
+    template<typename Input>
+    static constexpr auto pure(Input &&input)
+    {
+        return State{[value = std::forward<Input>(input)] <typename S> (S state) {
+            return std::pair<std::remove_cvref_t<Input>, S>{value, std::move(state)};
+        }};
+    }
+
+    template<typename Func, typename Input>
+    static constexpr auto map(Func &&func, State<Input> &&input)
+    {
+        return map_impl(std::forward<Func>(func), std::move(input.func));
+    }
+
+    template<typename Func, typename Input>
+    static constexpr auto map(Func &&func, const State<Input> &input)
+    {
+        return map_impl(std::forward<Func>(func), input.func);
+    }
+
+    // The function is computed first, then the value from the state it left behind.
+    template<typename Func, typename Input>
+        requires is_instance_v<State, Input>
+    static constexpr auto apply(State<Func> &&func, Input &&input)
+    {
+        return apply_impl(std::move(func.func), std::forward<Input>(input).func);
+    }
+
+    template<typename Func, typename Input>
+        requires is_instance_v<State, Input>
+    static constexpr auto apply(const State<Func> &func, Input &&input)
+    {
+        return apply_impl(func.func, std::forward<Input>(input).func);
+    }
+
+    template<typename Input>
+    static constexpr auto join(State<Input> &&input)
+    {
+        return join_impl(std::move(input.func));
+    }
+
+    template<typename Input>
+    static constexpr auto join(const State<Input> &input)
+    {
+        return join_impl(input.func);
+    }
+
+private:
+    template<typename Func, typename InputFunc>
+    static constexpr auto map_impl(Func &&func, InputFunc &&input)
+    {
+        return State{[func = std::forward<Func>(func), input = std::forward<InputFunc>(input)] <typename S> (S state) {
+            auto [value, next] = std::invoke(input, std::move(state));
+            using Result = std::remove_cvref_t<std::invoke_result_t<const std::remove_cvref_t<Func> &, decltype(value) &&>>;
+            return std::pair<Result, decltype(next)>{std::invoke(func, std::move(value)), std::move(next)};
+        }};
+    }
+
+    template<typename Func, typename InputFunc>
+    static constexpr auto apply_impl(Func &&func, InputFunc &&input)
+    {
+        return State{[func = std::forward<Func>(func), input = std::forward<InputFunc>(input)] <typename S> (S state) {
+            auto [wrapped_func, after_func] = std::invoke(func, std::move(state));
+            auto [value, after_value] = std::invoke(input, std::move(after_func));
+            using Result = std::remove_cvref_t<std::invoke_result_t<decltype(wrapped_func) &, decltype(value) &&>>;
+            return std::pair<Result, decltype(after_value)>{std::invoke(wrapped_func, std::move(value)), std::move(after_value)};
+        }};
+    }
+
+    template<typename InputFunc>
+    static constexpr auto join_impl(InputFunc &&input)
+    {
+        return State{[input = std::forward<InputFunc>(input)] <typename S> (S state) {
+            auto [inner, next] = std::invoke(input, std::move(state));
+            return std::move(inner).run(std::move(next));
+        }};
+    }
+};
+
+// The nested State is only known once the state type is, so the generic fjoin constraint on
+// T<T<...>> does not apply; these overloads make fbind and operator>> work through ADL.
+template<typename Func>
+constexpr auto fjoin(State<Func> &&input)
+{
+    return FunctionalTraits<State>::join(std::move(input));
+}
+
+template<typename Func>
+constexpr auto fjoin(const State<Func> &input)
+{
+    return FunctionalTraits<State>::join(input);
+}
+
+} // namespace functional
@@ -0,0 +1,374 @@
+#pragma once
+
+#include <algorithm>
+#include <condition_variable>
+#include <coroutine>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <stop_token>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "functional_monad.hpp"
+
+namespace functional
+{
+
+// Pull-based coroutine generator. Elements are produced one at a time when the consumer advances,
+// so a chain of fmap/fbind stages keeps a single element in flight whatever the input length.
+// Use buffered() to decouple a producer stage onto its own thread with a bounded queue.
+template<typename T>
+class [[nodiscard]] Stream final
+{
+public:
+    struct promise_type final
+    {
+        Stream get_return_object() noexcept
+        {
+            return Stream{std::coroutine_handle<promise_type>::from_promise(*this)};
+        }
+
+        std::suspend_always initial_suspend() noexcept
+        {
+            return {};
+        }
+
+        std::suspend_always final_suspend() noexcept
+        {
+            return {};
+        }
+
+        // The yielded object outlives the suspension, so only its address is kept.
+        std::suspend_always yield_value(T &value) noexcept
+        {
+            current = std::addressof(value);
+            return {};
+        }
+
+        std::suspend_always yield_value(T &&value) noexcept
+        {
+            current = std::addressof(value);
+            return {};
+        }
+
+        void return_void() noexcept
+        {
+        }
+
+        void unhandled_exception() noexcept
+        {
+            exception = std::current_exception();
+        }
+
+        template<typename Awaitable>
+        Awaitable &&await_transform(Awaitable &&) = delete;
+
+        T *current = nullptr;
+        std::exception_ptr exception;
+    };
+
+    class iterator final
+    {
+    public:
+        using value_type = T;
+        using reference = T &;
+        using difference_type = std::ptrdiff_t;
+        using iterator_concept = std::input_iterator_tag;
+
+        iterator() noexcept = default;
+
+        explicit iterator(std::coroutine_handle<promise_type> handle) noexcept
+            : handle_(handle)
+        {
+        }
+
+        reference operator*() const noexcept
+        {
+            return *handle_.promise().current;
+        }
+
+        iterator &operator++()
+        {
+            Stream::advance(handle_);
+            return *this;
+        }
+
+        void operator++(int)
+        {
+            ++*this;
+        }
+
+        friend bool operator==(const iterator &it, std::default_sentinel_t) noexcept
+        {
+            return !it.handle_ || it.handle_.done();
+        }
+
+    private:
+        std::coroutine_handle<promise_type> handle_;
+    };
+
+    Stream(Stream &&other) noexcept
+        : handle_(std::exchange(other.handle_, {}))
+    {
+    }
+
+    Stream &operator=(Stream &&other) noexcept
+    {
+        if (this != &other)
+        {
+            destroy();
+            handle_ = std::exchange(other.handle_, {});
+        }
+        return *this;
+    }
+
+    ~Stream()
+    {
+        destroy();
+    }
+
+    // Single pass: begin() starts the producer and may only be called once.
+    iterator begin()
+    {
+        advance(handle_);
+        return iterator{handle_};
+    }
+
+    std::default_sentinel_t end() const noexcept
+    {
+        return {};
+    }
+
+private:
+    explicit Stream(std::coroutine_handle<promise_type> handle) noexcept
+        : handle_(handle)
+    {
+    }
+
+    static void advance(std::coroutine_handle<promise_type> handle)
+    {
+        handle.resume();
+        if (handle.done() && handle.promise().exception)
+        {
+            std::rethrow_exception(std::exchange(handle.promise().exception, {}));
+        }
+    }
+
+    void destroy() noexcept
+    {
+        if (handle_)
+        {
+            handle_.destroy();
+        }
+    }
+
+    std::coroutine_handle<promise_type> handle_;
+};
+
+template<>
+struct FunctionalTraits<Stream> final
+{
+    static constexpr bool single_shot = true;
+
+    template<typename Input>
+    static auto pure(Input &&input)
+    {
+        return single<std::remove_cvref_t<Input>>(std::forward<Input>(input));
+    }
+
+    template<typename Func, typename Input>
+    static auto map(Func &&func, Stream<Input> &&input)
+    {
+        return map_impl<Input>(std::forward<Func>(func), std::move(input));
+    }
+
+    // Every function is applied to every value. With a single function the values are streamed
+    // straight through; several functions need the values more than once, so those are cached.
+    template<typename Func, typename Input>
+        requires is_instance_v<Stream, Input> && std::is_rvalue_reference_v<Input &&>
+    static auto apply(Stream<Func> &&func, Input &&input)
+    {
+        return apply_impl(std::move(func), std::move(input));
+    }
+
+    template<typename Input>
+        requires is_instance_v<Stream, Input>
+    static Input join(Stream<Input> &&input)
+    {
+        return join_impl(std::move(input));
+    }
+
+private:
+    template<typename Value>
+    static Stream<Value> single(Value value)
+    {
+        co_yield value;
+    }
+
+    template<typename Input, typename Func>
+    static Stream<std::remove_cvref_t<std::invoke_result_t<Func &, Input &&>>> map_impl(Func func, Stream<Input> input)
+    {
+        for (auto &value : input)
+        {
+            co_yield std::invoke(func, std::move(value));
+        }
+    }
+
+    template<typename Func, typename Input>
+    static Stream<std::remove_cvref_t<std::invoke_result_t<Func &, Input &&>>> apply_impl(Stream<Func> func, Stream<Input> input)
+    {
+        auto func_it = func.begin();
+        if (func_it == func.end())
+        {
+            co_return;
+        }
+        Func first_func = std::move(*func_it);
+        ++func_it;
+        if (func_it == func.end())
+        {
+            for (auto &value : input)
+            {
+                co_yield std::invoke(first_func, std::move(value));
+            }
+            co_return;
+        }
+        if constexpr (std::is_copy_constructible_v<Input>)
+        {
+            std::vector<Input> values;
+            for (auto &value : input)
+            {
+                values.push_back(std::move(value));
+            }
+            for (const auto &value : values)
+            {
+                co_yield std::invoke(first_func, Input(value));
+            }
+            for (; func_it != func.end(); ++func_it)
+            {
+                for (const auto &value : values)
+                {
+                    co_yield std::invoke(*func_it, Input(value));
+                }
+            }
+        }
+        else
+        {
+            throw std::invalid_argument("move-only stream values can be consumed by a single function only");
+        }
+    }
+
+    template<typename Input>
+    static Input join_impl(Stream<Input> input)
+    {
+        for (auto &inner : input)
+        {
+            for (auto &value : inner)
+            {
+                co_yield std::move(value);
+            }
+        }
+    }
+};
+
+namespace detail
+{
+
+template<typename T>
+class BoundedChannel final
+{
+public:
+    explicit BoundedChannel(std::size_t capacity)
+        : capacity_(std::max<std::size_t>(capacity, 1))
+    {
+    }
+
+    // Blocks while the channel is full; returns false once the consumer has gone away.
+    bool push(T value, std::stop_token stop)
+    {
+        std::unique_lock lock{mutex_};
+        if (!not_full_.wait(lock, stop, [this] { return values_.size() < capacity_; }))
+        {
+            return false;
+        }
+        values_.push_back(std::move(value));
+        not_empty_.notify_one();
+        return true;
+    }
+
+    void close(std::exception_ptr exception = {})
+    {
+        std::lock_guard lock{mutex_};
+        closed_ = true;
+        exception_ = std::move(exception);
+        not_empty_.notify_one();
+    }
+
+    std::optional<T> pop()
+    {
+        std::unique_lock lock{mutex_};
+        not_empty_.wait(lock, [this] { return !values_.empty() || closed_; });
+        if (values_.empty())
+        {
+            if (exception_)
+            {
+                std::rethrow_exception(exception_);
+            }
+            return std::nullopt;
+        }
+        std::optional<T> value{std::move(values_.front())};
+        values_.pop_front();
+        not_full_.notify_one();
+        return value;
+    }
+
+private:
+    std::size_t capacity_;
+    std::mutex mutex_;
+    std::condition_variable_any not_full_;
+    std::condition_variable not_empty_;
+    std::deque<T> values_;
+    bool closed_ = false;
+    std::exception_ptr exception_;
+};
+
+} // namespace detail
+
+// Runs upstream on its own thread, at most `capacity` elements ahead of the consumer: a slow
+// consumer blocks the producer, and dropping the result stops it.
+template<typename T>
+Stream<T> buffered(Stream<T> upstream, std::size_t capacity)
+{
+    auto channel = std::make_shared<detail::BoundedChannel<T>>(capacity);
+    std::jthread producer{[channel, upstream = std::move(upstream)] (std::stop_token stop) mutable {
+        try
+        {
+            for (auto &value : upstream)
+            {
+                if (!channel->push(std::move(value), stop))
+                {
+                    break;
+                }
+            }
+            channel->close();
+        }
+        catch (...)
+        {
+            channel->close(std::current_exception());
+        }
+    }};
+    while (auto value = channel->pop())
+    {
+        co_yield std::move(*value);
+    }
+}
+
+} // namespace functional
@@ -0,0 +1,304 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <coroutine>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <type_traits>
+#include <utility>
+#include <variant>
+
+#include "functional_monad.hpp"
+#include "functional_thread_pool.hpp"
+
+namespace functional
+{
+
+namespace detail
+{
+
+// Shared by the operands of a fork: the last one to finish resumes the joining coroutine.
+struct TaskJoin final
+{
+    std::atomic<std::size_t> remaining;
+    std::coroutine_handle<> continuation;
+
+    std::coroutine_handle<> arrive() noexcept
+    {
+        if (remaining.fetch_sub(1, std::memory_order_acq_rel) == 1)
+        {
+            return continuation;
+        }
+        return std::noop_coroutine();
+    }
+};
+
+struct TaskLatch final
+{
+    std::mutex mutex;
+    std::condition_variable finished;
+    bool done = false;
+
+    void count_down()
+    {
+        std::lock_guard lock{mutex};
+        done = true;
+        finished.notify_all();
+    }
+
+    void wait()
+    {
+        std::unique_lock lock{mutex};
+        finished.wait(lock, [this] { return done; });
+    }
+};
+
+} // namespace detail
+
+// Lazily started, single-shot coroutine producing a T. Awaiting a Task runs it inline through
+// symmetric transfer; get() runs it on the calling thread and blocks until it has finished.
+template<typename T>
+class [[nodiscard]] Task final
+{
+public:
+    struct promise_type final
+    {
+        Task get_return_object() noexcept
+        {
+            return Task{std::coroutine_handle<promise_type>::from_promise(*this)};
+        }
+
+        std::suspend_always initial_suspend() noexcept
+        {
+            return {};
+        }
+
+        auto final_suspend() noexcept
+        {
+            struct FinalAwaiter final
+            {
+                bool await_ready() noexcept
+                {
+                    return false;
+                }
+
+                std::coroutine_handle<> await_suspend(std::coroutine_handle<promise_type> handle) noexcept
+                {
+                    auto &promise = handle.promise();
+                    if (promise.latch)
+                    {
+                        promise.latch->count_down();
+                        return std::noop_coroutine();
+                    }
+                    if (promise.join)
+                    {
+                        return promise.join->arrive();
+                    }
+                    return promise.continuation;
+                }
+
+                void await_resume() noexcept
+                {
+                }
+            };
+            return FinalAwaiter{};
+        }
+
+        template<typename Value>
+        void return_value(Value &&value)
+        {
+            result.template emplace<1>(std::forward<Value>(value));
+        }
+
+        void unhandled_exception() noexcept
+        {
+            result.template emplace<2>(std::current_exception());
+        }
+
+        std::variant<std::monostate, T, std::exception_ptr> result;
+        std::coroutine_handle<> continuation = std::noop_coroutine();
+        detail::TaskJoin *join = nullptr;
+        detail::TaskLatch *latch = nullptr;
+    };
+
+    Task(Task &&other) noexcept
+        : handle_(std::exchange(other.handle_, {}))
+    {
+    }
+
+    Task &operator=(Task &&other) noexcept
+    {
+        if (this != &other)
+        {
+            destroy();
+            handle_ = std::exchange(other.handle_, {});
+        }
+        return *this;
+    }
+
+    ~Task()
+    {
+        destroy();
+    }
+
+    auto operator co_await() && noexcept
+    {
+        struct TaskAwaiter final
+        {
+            std::coroutine_handle<promise_type> handle;
+
+            bool await_ready() const noexcept
+            {
+                return false;
+            }
+
+            std::coroutine_handle<> await_suspend(std::coroutine_handle<> continuation) noexcept
+            {
+                handle.promise().continuation = continuation;
+                return handle;
+            }
+
+            T await_resume()
+            {
+                return take_result(handle);
+            }
+        };
+        return TaskAwaiter{handle_};
+    }
+
+    T get() &&
+    {
+        detail::TaskLatch latch;
+        handle_.promise().latch = &latch;
+        handle_.resume();
+        latch.wait();
+        return take_result(handle_);
+    }
+
+private:
+    template<typename>
+    friend class Task;
+
+    friend struct FunctionalTraits<Task>;
+
+    explicit Task(std::coroutine_handle<promise_type> handle) noexcept
+        : handle_(handle)
+    {
+    }
+
+    static T take_result(std::coroutine_handle<promise_type> handle)
+    {
+        auto &result = handle.promise().result;
+        if (auto *exception = std::get_if<std::exception_ptr>(&result))
+        {
+            std::rethrow_exception(*exception);
+        }
+        return std::move(std::get<T>(result));
+    }
+
+    void destroy() noexcept
+    {
+        if (handle_)
+        {
+            handle_.destroy();
+        }
+    }
+
+    std::coroutine_handle<promise_type> handle_;
+};
+
+template<>
+struct FunctionalTraits<Task> final
+{
+    static constexpr bool single_shot = true;
+
+    template<typename Input>
+    static auto pure(Input &&input)
+    {
+        return make_ready<std::remove_cvref_t<Input>>(std::forward<Input>(input));
+    }
+
+    template<typename Func, typename Input>
+    static auto map(Func &&func, Task<Input> &&input)
+    {
+        return map_impl<Input>(std::forward<Func>(func), std::move(input));
+    }
+
+    // Both sides are independent, so they are forked onto ThreadPool::global() and joined before
+    // the function is called.
+    template<typename Func, typename Input>
+        requires is_instance_v<Task, Input> && std::is_rvalue_reference_v<Input &&>
+    static auto apply(Task<Func> &&func, Input &&input)
+    {
+        return apply_impl(std::move(func), std::move(input), ThreadPool::global());
+    }
+
+    template<typename Input>
+        requires is_instance_v<Task, Input>
+    static Input join(Task<Input> &&input)
+    {
+        return join_impl(std::move(input));
+    }
+
+private:
+    template<typename Value>
+    static Task<Value> make_ready(Value value)
+    {
+        co_return std::move(value);
+    }
+
+    template<typename Input, typename Func>
+    static Task<std::remove_cvref_t<std::invoke_result_t<Func &&, Input &&>>> map_impl(Func func, Task<Input> input)
+    {
+        co_return std::invoke(std::move(func), co_await std::move(input));
+    }
+
+    template<typename Input>
+    static Input join_impl(Task<Input> input)
+    {
+        co_return co_await co_await std::move(input);
+    }
+
+    template<typename Func, typename Input>
+    static Task<std::remove_cvref_t<std::invoke_result_t<Func &&, Input &&>>> apply_impl(Task<Func> func, Task<Input> input, ThreadPool &pool)
+    {
+        co_await fork_join(pool, func.handle_, input.handle_);
+        co_return std::invoke(Task<Func>::take_result(func.handle_), Task<Input>::take_result(input.handle_));
+    }
+
+    template<typename LhsHandle, typename RhsHandle>
+    static auto fork_join(ThreadPool &pool, LhsHandle lhs, RhsHandle rhs) noexcept
+    {
+        struct ForkJoinAwaiter final
+        {
+            ThreadPool &pool;
+            LhsHandle lhs;
+            RhsHandle rhs;
+            detail::TaskJoin join{2, {}};
+
+            bool await_ready() const noexcept
+            {
+                return false;
+            }
+
+            void await_suspend(std::coroutine_handle<> continuation)
+            {
+                join.continuation = continuation;
+                lhs.promise().join = &join;
+                rhs.promise().join = &join;
+                pool.post(lhs);
+                pool.post(rhs);
+            }
+
+            void await_resume() const noexcept
+            {
+            }
+        };
+        return ForkJoinAwaiter{pool, lhs, rhs};
+    }
+};
+
+} // namespace functional
@@ -0,0 +1,476 @@
+#pragma once
+
+#include <any>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "functional_monad.hpp"
+#include "functional_alternative.hpp"
+
+namespace functional
+{
+
+// State of one parse run over a text. Failures record the furthest position reached and what was
+// expected there; the packrat table is only created once a memoize()d parser runs.
+struct TextInput final
+{
+    explicit TextInput(std::string_view text_) noexcept
+        : text(text_)
+    {
+    }
+
+    void fail(std::size_t position, std::string_view what) noexcept
+    {
+        if (position >= error_position)
+        {
+            error_position = position;
+            expected = what;
+        }
+    }
+
+    struct MemoKey final
+    {
+        const void *parser;
+        std::size_t position;
+
+        friend bool operator==(const MemoKey &, const MemoKey &) = default;
+    };
+
+    struct MemoKeyHash final
+    {
+        std::size_t operator()(const MemoKey &key) const noexcept
+        {
+            return std::hash<const void *>{}(key.parser) ^ (key.position * 0x9e3779b97f4a7c15ull);
+        }
+    };
+
+    std::string_view text;
+    std::size_t error_position = 0;
+    std::string_view expected;
+    std::unique_ptr<std::unordered_map<MemoKey, std::any, MemoKeyHash>> memo;
+};
+
+namespace detail
+{
+
+// A parser either produces a value and advances position, or fails and leaves position unchanged.
+template<typename T>
+struct TextParserNode
+{
+    virtual ~TextParserNode() = default;
+    virtual std::optional<T> parse(TextInput &input, std::size_t &position) const = 0;
+};
+
+template<typename T, typename Func>
+struct TextParserFunctionNode final : TextParserNode<T>
+{
+    explicit TextParserFunctionNode(Func func_)
+        : func(std::move(func_))
+    {
+    }
+
+    std::optional<T> parse(TextInput &input, std::size_t &position) const override
+    {
+        return func(input, position);
+    }
+
+    Func func;
+};
+
+} // namespace detail
+
+template<typename T>
+class TextParser final
+{
+public:
+    using value_type = T;
+
+    // A default constructed parser always fails; it is the Alternative identity.
+    constexpr TextParser() noexcept = default;
+
+    explicit TextParser(std::shared_ptr<const detail::TextParserNode<T>> node) noexcept
+        : node_(std::move(node))
+    {
+    }
+
+    std::optional<T> parse(TextInput &input, std::size_t &position) const
+    {
+        if (!node_)
+        {
+            input.fail(position, "nothing");
+            return std::nullopt;
+        }
+        return node_->parse(input, position);
+    }
+
+    const void *identity() const noexcept
+    {
+        return node_.get();
+    }
+
+private:
+    std::shared_ptr<const detail::TextParserNode<T>> node_;
+};
+
+template<typename T, typename Func>
+TextParser<T> make_text_parser(Func &&func)
+{
+    using Node = detail::TextParserFunctionNode<T, std::remove_cvref_t<Func>>;
+    return TextParser<T>{std::make_shared<const Node>(std::forward<Func>(func))};
+}
+
+// expected is copied out of the parser that failed, so the result outlives the parser.
+template<typename T>
+struct TextParseResult final
+{
+    std::optional<T> value;
+    std::size_t position = 0;
+    std::size_t error_position = 0;
+    std::string expected;
+};
+
+template<typename T>
+TextParseResult<T> parse_text(const TextParser<T> &parser, std::string_view text)
+{
+    TextInput input{text};
+    std::size_t position = 0;
+    auto value = parser.parse(input, position);
+    return {std::move(value), position, input.error_position, std::string(input.expected)};
+}
+
+template<>
+struct FunctionalTraits<TextParser> final
+{
+    // A parser can run many times, so the value is copied out on every run. A move-only value
+    // could only be produced once, so it is rejected; the overload exists for the concepts.
+    template<typename Input>
+    static auto pure(Input &&input) -> TextParser<std::remove_cvref_t<Input>>
+    {
+        using Value = std::remove_cvref_t<Input>;
+        if constexpr (std::is_copy_constructible_v<Value>)
+        {
+            return make_text_parser<Value>([value = std::forward<Input>(input)] (TextInput &, std::size_t &) {
+                return std::optional<Value>{value};
+            });
+        }
+        else
+        {
+            throw std::invalid_argument("text parsers can only produce copyable pure values");
+        }
+    }
+
+    template<typename Func, typename Input>
+    static auto map(Func &&func, TextParser<Input> input)
+    {
+        using FuncRet = std::remove_cvref_t<std::invoke_result_t<const std::remove_cvref_t<Func> &, Input &&>>;
+        return make_text_parser<FuncRet>([inner = std::move(input), func = std::forward<Func>(func)] (TextInput &text_input, std::size_t &position) -> std::optional<FuncRet> {
+            auto value = inner.parse(text_input, position);
+            if (!value)
+            {
+                return std::nullopt;
+            }
+            return std::optional<FuncRet>{std::invoke(func, std::move(*value))};
+        });
+    }
+
+    template<typename Func, typename Input>
+        requires is_instance_v<TextParser, Input>
+    static auto apply(TextParser<Func> func, Input &&input)
+    {
+        using Value = typename std::remove_cvref_t<Input>::value_type;
+        using FuncRet = std::remove_cvref_t<std::invoke_result_t<Func &&, Value &&>>;
+        return make_text_parser<FuncRet>([func = std::move(func), value_parser = std::forward<Input>(input)] (TextInput &text_input, std::size_t &position) -> std::optional<FuncRet> {
+            const std::size_t start = position;
+            auto wrapped_func = func.parse(text_input, position);
+            if (!wrapped_func)
+            {
+                return std::nullopt;
+            }
+            auto value = value_parser.parse(text_input, position);
+            if (!value)
+            {
+                position = start;
+                return std::nullopt;
+            }
+            return std::optional<FuncRet>{std::invoke(std::move(*wrapped_func), std::move(*value))};
+        });
+    }
+
+    template<typename Input>
+        requires is_instance_v<TextParser, Input>
+    static Input join(TextParser<Input> input)
+    {
+        using Value = typename Input::value_type;
+        return make_text_parser<Value>([outer = std::move(input)] (TextInput &text_input, std::size_t &position) -> std::optional<Value> {
+            const std::size_t start = position;
+            auto inner = outer.parse(text_input, position);
+            if (!inner)
+            {
+                return std::nullopt;
+            }
+            auto value = inner->parse(text_input, position);
+            if (!value)
+            {
+                position = start;
+            }
+            return value;
+        });
+    }
+
+    // PEG ordered choice: rhs is tried from the same position when lhs fails. Wrap shared
+    // sub-grammars in memoize() to keep the backtracking linear.
+    template<typename InputLeft, typename InputRight>
+        requires std::same_as<TextParser<InputLeft>, std::remove_cvref_t<InputRight>>
+    static auto alternate(TextParser<InputLeft> lhs, InputRight &&rhs)
+    {
+        return make_text_parser<InputLeft>([lhs = std::move(lhs), rhs = std::forward<InputRight>(rhs)] (TextInput &text_input, std::size_t &position) {
+            auto value = lhs.parse(text_input, position);
+            if (value)
+            {
+                return value;
+            }
+            return rhs.parse(text_input, position);
+        });
+    }
+};
+
+// Character-level building blocks.
+
+class CharClass final
+{
+public:
+    // "a-z_" style set: single characters and ranges.
+    explicit constexpr CharClass(std::string_view set) noexcept
+    {
+        for (std::size_t idx = 0; idx < set.size(); ++idx)
+        {
+            if (idx + 2 < set.size() && set[idx + 1] == '-')
+            {
+                for (unsigned ch = static_cast<unsigned char>(set[idx]); ch <= static_cast<unsigned char>(set[idx + 2]); ++ch)
+                {
+                    add(static_cast<unsigned char>(ch));
+                }
+                idx += 2;
+            }
+            else
+            {
+                add(static_cast<unsigned char>(set[idx]));
+            }
+        }
+    }
+
+    constexpr bool contains(char ch) const noexcept
+    {
+        const auto value = static_cast<unsigned char>(ch);
+        return (bits_[value / 64] >> (value % 64)) & 1u;
+    }
+
+private:
+    constexpr void add(unsigned char ch) noexcept
+    {
+        bits_[ch / 64] |= std::uint64_t{1} << (ch % 64);
+    }
+
+    std::array<std::uint64_t, 4> bits_{};
+};
+
+// The parsers below keep their own copies of set, description and text, which failures report
+// as what was expected.
+inline TextParser<char> char_class(std::string_view set, std::string_view description)
+{
+    return make_text_parser<char>([chars = CharClass{set}, description = std::string(description)] (TextInput &input, std::size_t &position) -> std::optional<char> {
+        if (position < input.text.size() && chars.contains(input.text[position]))
+        {
+            return input.text[position++];
+        }
+        input.fail(position, description);
+        return std::nullopt;
+    });
+}
+
+inline TextParser<char> char_class(std::string_view set)
+{
+    return char_class(set, set);
+}
+
+// Longest run (at least min_count long) of characters from the class, without a per-character
+// parser call: this is the fast path for tokens.
+inline TextParser<std::string_view> take_while(std::string_view set, std::size_t min_count = 0)
+{
+    return make_text_parser<std::string_view>([chars = CharClass{set}, set = std::string(set), min_count] (TextInput &input, std::size_t &position) -> std::optional<std::string_view> {
+        const std::size_t start = position;
+        std::size_t end = start;
+        while (end < input.text.size() && chars.contains(input.text[end]))
+        {
+            ++end;
+        }
+        if (end - start < min_count)
+        {
+            input.fail(end, set);
+            return std::nullopt;
+        }
+        position = end;
+        return input.text.substr(start, end - start);
+    });
+}
+
+inline TextParser<std::string_view> literal(std::string_view text)
+{
+    return make_text_parser<std::string_view>([text = std::string(text)] (TextInput &input, std::size_t &position) -> std::optional<std::string_view> {
+        if (input.text.substr(position, text.size()) != text)
+        {
+            input.fail(position, text);
+            return std::nullopt;
+        }
+        position += text.size();
+        return input.text.substr(position - text.size(), text.size());
+    });
+}
+
+inline TextParser<std::string_view> spaces()
+{
+    return take_while(" \t\r\n");
+}
+
+inline TextParser<std::size_t> end_of_input()
+{
+    return make_text_parser<std::size_t>([] (TextInput &input, std::size_t &position) -> std::optional<std::size_t> {
+        if (position != input.text.size())
+        {
+            input.fail(position, "end of input");
+            return std::nullopt;
+        }
+        return position;
+    });
+}
+
+template<typename T>
+TextParser<std::vector<T>> many(TextParser<T> parser, std::size_t min_count = 0)
+{
+    return make_text_parser<std::vector<T>>([parser = std::move(parser), min_count] (TextInput &input, std::size_t &position) -> std::optional<std::vector<T>> {
+        const std::size_t start = position;
+        std::vector<T> values;
+        while (true)
+        {
+            const std::size_t before = position;
+            auto value = parser.parse(input, position);
+            if (!value || position == before)
+            {
+                break;
+            }
+            values.push_back(std::move(*value));
+        }
+        if (values.size() < min_count)
+        {
+            position = start;
+            return std::nullopt;
+        }
+        return values;
+    });
+}
+
+template<typename T>
+TextParser<std::vector<T>> many1(TextParser<T> parser)
+{
+    return many(std::move(parser), 1);
+}
+
+template<typename T, typename Sep>
+TextParser<std::vector<T>> sep_by(TextParser<T> parser, TextParser<Sep> separator)
+{
+    return make_text_parser<std::vector<T>>([parser = std::move(parser), separator = std::move(separator)] (TextInput &input, std::size_t &position) -> std::optional<std::vector<T>> {
+        std::vector<T> values;
+        auto first = parser.parse(input, position);
+        if (!first)
+        {
+            return values;
+        }
+        values.push_back(std::move(*first));
+        while (true)
+        {
+            const std::size_t before = position;
+            if (!separator.parse(input, position))
+            {
+                break;
+            }
+            auto value = parser.parse(input, position);
+            if (!value)
+            {
+                position = before;
+                break;
+            }
+            values.push_back(std::move(*value));
+        }
+        return values;
+    });
+}
+
+// Runs parser and skips the whitespace after it.
+template<typename T>
+TextParser<T> token(TextParser<T> parser)
+{
+    return make_text_parser<T>([parser = std::move(parser)] (TextInput &input, std::size_t &position) -> std::optional<T> {
+        auto value = parser.parse(input, position);
+        if (value)
+        {
+            while (position < input.text.size() && (input.text[position] == ' ' || input.text[position] == '\t'
+                                                    || input.text[position] == '\r' || input.text[position] == '\n'))
+            {
+                ++position;
+            }
+        }
+        return value;
+    });
+}
+
+// Packrat memoization: each (parser, position) pair is evaluated at most once per parse run.
+template<typename T>
+    requires std::is_copy_constructible_v<T>
+TextParser<T> memoize(TextParser<T> parser)
+{
+    using Entry = std::pair<std::optional<T>, std::size_t>;
+    return make_text_parser<T>([parser = std::move(parser)] (TextInput &input, std::size_t &position) -> std::optional<T> {
+        if (!input.memo)
+        {
+            input.memo = std::make_unique<std::unordered_map<TextInput::MemoKey, std::any, TextInput::MemoKeyHash>>();
+        }
+        const TextInput::MemoKey key{parser.identity(), position};
+        if (const auto found = input.memo->find(key); found != input.memo->end())
+        {
+            const auto &entry = std::any_cast<const Entry &>(found->second);
+            position = entry.second;
+            return entry.first;
+        }
+        const std::size_t start = position;
+        auto value = parser.parse(input, position);
+        input.memo->insert_or_assign(TextInput::MemoKey{parser.identity(), start}, Entry{value, position});
+        return value;
+    });
+}
+
+// For recursive grammars: build receives a parser that refers to the one being built.
+template<typename T, typename Build>
+TextParser<T> recursive(Build &&build)
+{
+    auto slot = std::make_shared<TextParser<T>>();
+    const auto self = make_text_parser<T>([weak_slot = std::weak_ptr<TextParser<T>>(slot)] (TextInput &input, std::size_t &position) {
+        return weak_slot.lock()->parse(input, position);
+    });
+    *slot = std::forward<Build>(build)(self);
+    return make_text_parser<T>([slot] (TextInput &input, std::size_t &position) {
+        return slot->parse(input, position);
+    });
+}
+
+} // namespace functional
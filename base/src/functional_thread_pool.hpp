@@ -0,0 +1,192 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <coroutine>
+#include <cstddef>
+#include <deque>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <vector>
+
+namespace functional
+{
+
+namespace detail
+{
+
+inline std::size_t parallel_worker_count() noexcept
+{
+    return std::max(1u, std::thread::hardware_concurrency());
+}
+
+} // namespace detail
+
+// Work-stealing executor for coroutines. Every worker owns a deque: work posted from a worker goes
+// to the back of its own deque and is popped LIFO, idle workers steal FIFO from the front of the
+// others. Work posted from outside the pool is spread round-robin over the deques.
+// All posted coroutines must have finished before the pool is destroyed.
+class ThreadPool final
+{
+public:
+    explicit ThreadPool(std::size_t worker_count = detail::parallel_worker_count())
+        : queues_(std::max<std::size_t>(worker_count, 1))
+    {
+        workers_.reserve(queues_.size());
+        for (std::size_t idx = 0; idx < queues_.size(); ++idx)
+        {
+            workers_.emplace_back([this, idx] { run_worker(idx); });
+        }
+    }
+
+    ThreadPool(const ThreadPool &) = delete;
+    ThreadPool &operator=(const ThreadPool &) = delete;
+
+    ~ThreadPool()
+    {
+        {
+            std::lock_guard lock{sleep_mutex_};
+            stopped_ = true;
+        }
+        wake_.notify_all();
+        workers_.clear();
+    }
+
+    static ThreadPool &global()
+    {
+        static ThreadPool pool;
+        return pool;
+    }
+
+    // Whether the calling thread is one of this pool's workers.
+    bool is_worker_thread() const noexcept
+    {
+        return current_pool_ == this;
+    }
+
+    std::size_t worker_count() const noexcept
+    {
+        return queues_.size();
+    }
+
+    void post(std::coroutine_handle<> handle)
+    {
+        const std::size_t queue_idx = current_pool_ == this
+            ? current_worker_
+            : next_queue_.fetch_add(1, std::memory_order_relaxed) % queues_.size();
+        // Counted before it is published, so a worker that takes it right away cannot drive
+        // pending_ below zero.
+        {
+            std::lock_guard lock{sleep_mutex_};
+            ++pending_;
+        }
+        {
+            std::lock_guard lock{queues_[queue_idx].mutex};
+            queues_[queue_idx].handles.push_back(handle);
+        }
+        wake_.notify_one();
+    }
+
+    // co_await pool.schedule() continues the awaiting coroutine on one of the workers.
+    auto schedule() noexcept
+    {
+        struct ScheduleAwaiter final
+        {
+            ThreadPool &pool;
+
+            constexpr bool await_ready() const noexcept
+            {
+                return false;
+            }
+
+            void await_suspend(std::coroutine_handle<> handle)
+            {
+                pool.post(handle);
+            }
+
+            constexpr void await_resume() const noexcept
+            {
+            }
+        };
+        return ScheduleAwaiter{*this};
+    }
+
+private:
+    struct WorkerQueue final
+    {
+        std::mutex mutex;
+        std::deque<std::coroutine_handle<>> handles;
+    };
+
+    std::optional<std::coroutine_handle<>> pop_local(std::size_t idx)
+    {
+        std::lock_guard lock{queues_[idx].mutex};
+        if (queues_[idx].handles.empty())
+        {
+            return std::nullopt;
+        }
+        const auto handle = queues_[idx].handles.back();
+        queues_[idx].handles.pop_back();
+        return handle;
+    }
+
+    std::optional<std::coroutine_handle<>> steal(std::size_t thief_idx)
+    {
+        for (std::size_t offset = 1; offset < queues_.size(); ++offset)
+        {
+            auto &victim = queues_[(thief_idx + offset) % queues_.size()];
+            std::lock_guard lock{victim.mutex};
+            if (!victim.handles.empty())
+            {
+                const auto handle = victim.handles.front();
+                victim.handles.pop_front();
+                return handle;
+            }
+        }
+        return std::nullopt;
+    }
+
+    void run_worker(std::size_t idx)
+    {
+        current_pool_ = this;
+        current_worker_ = idx;
+        while (true)
+        {
+            auto handle = pop_local(idx);
+            if (!handle)
+            {
+                handle = steal(idx);
+            }
+            if (handle)
+            {
+                {
+                    std::lock_guard lock{sleep_mutex_};
+                    --pending_;
+                }
+                handle->resume();
+                continue;
+            }
+            std::unique_lock lock{sleep_mutex_};
+            wake_.wait(lock, [this] { return stopped_ || pending_ > 0; });
+            if (stopped_ && pending_ == 0)
+            {
+                return;
+            }
+        }
+    }
+
+    static inline thread_local ThreadPool *current_pool_ = nullptr;
+    static inline thread_local std::size_t current_worker_ = 0;
+
+    std::vector<WorkerQueue> queues_;
+    std::atomic<std::size_t> next_queue_ = 0;
+    std::mutex sleep_mutex_;
+    std::condition_variable wake_;
+    std::size_t pending_ = 0;
+    bool stopped_ = false;
+    std::vector<std::jthread> workers_;
+};
+
+} // namespace functional
@@ -19,43 +19,55 @@ template<template<typename> typename T>
 struct FunctionalTraits final
 {
     template<typename Func, typename Input>
-    static constexpr auto map(Func &&func, T<Input> &&input)
+#define CALL_TEXT std::move(input).map(std::forward<Func>(func))
+    static constexpr auto map(Func &&func, T<Input> &&input) noexcept(noexcept(CALL_TEXT))
     {
-        return std::move(input).map(std::forward<Func>(func));
+        return CALL_TEXT;
+#undef CALL_TEXT
     }
 
     template<typename Func, typename Input>
-    static constexpr auto map(Func &&func, const T<Input> &input)
+#define CALL_TEXT input.map(std::forward<Func>(func))
+    static constexpr auto map(Func &&func, const T<Input> &input) noexcept(noexcept(CALL_TEXT))
     {
-        return input.map(std::forward<Func>(func));
+        return CALL_TEXT;
+#undef CALL_TEXT
     }
 
     template<typename Func, typename Input>
         requires is_instance_v<T, Input>
-    static constexpr auto apply(T<Func> &&func, Input &&input)
+#define CALL_TEXT std::forward<Input>(input).apply(std::move(func))
+    static constexpr auto apply(T<Func> &&func, Input &&input) noexcept(noexcept(CALL_TEXT))
     {
-        return std::forward<Input>(input).apply(std::move(func));
+        return CALL_TEXT;
+#undef CALL_TEXT
     }
 
     template<typename Func, typename Input>
         requires is_instance_v<T, Input>
-    static constexpr auto apply(const T<Func> &func, Input &&input)
+#define CALL_TEXT std::forward<Input>(input).apply(func)
+    static constexpr auto apply(const T<Func> &func, Input &&input) noexcept(noexcept(CALL_TEXT))
     {
-        return std::forward<Input>(input).apply(func);
+        return CALL_TEXT;
+#undef CALL_TEXT
     }
 
     template<typename Input>
         requires is_instance_v<T, Input>
-    static constexpr auto join(T<Input> &&input)
+#define CALL_TEXT std::move(input).join()
+    static constexpr auto join(T<Input> &&input) noexcept(noexcept(CALL_TEXT))
     {
-        return std::move(input).join();
+        return CALL_TEXT;
+#undef CALL_TEXT
     }
 
     template<typename Input>
         requires is_instance_v<T, Input>
-    static constexpr auto join(const T<Input> &input)
+#define CALL_TEXT input.join()
+    static constexpr auto join(const T<Input> &input) noexcept(noexcept(CALL_TEXT))
     {
-        return input.join();
+        return CALL_TEXT;
+#undef CALL_TEXT
     }
 
     template<typename Input>
@@ -65,4 +77,11 @@ struct FunctionalTraits final
     }
 };
 
+// Instances whose values can be consumed only once (e.g. coroutine tasks) set
+// `static constexpr bool single_shot = true;` to opt out of the const & overloads.
+template<template<typename> typename T>
+concept SingleShot = requires {
+    requires FunctionalTraits<T>::single_shot;
+};
+
 } // namespace functional
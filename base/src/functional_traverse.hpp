@@ -0,0 +1,120 @@
+#pragma once
+
+#include <functional>
+#include <ranges>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "functional_applicative.hpp"
+#include "functional_partially_applicable.hpp"
+
+namespace functional
+{
+
+namespace detail
+{
+
+template<typename Range>
+constexpr std::size_t reserve_hint(Range &&range)
+{
+    if constexpr (std::ranges::sized_range<Range>)
+    {
+        return static_cast<std::size_t>(std::ranges::size(range));
+    }
+    else
+    {
+        return 0;
+    }
+}
+
+// Elements of an rvalue container are moved out, everything else is passed on as is. Views are
+// never moved from, even as rvalues: a view over the caller's container does not own its elements.
+template<typename Range, typename Element>
+constexpr decltype(auto) forward_range_element(Element &&element) noexcept
+{
+    if constexpr (!std::is_lvalue_reference_v<Range>
+                  && !std::ranges::borrowed_range<Range>
+                  && !std::ranges::view<std::remove_cvref_t<Range>>)
+    {
+        return std::move(element);
+    }
+    else
+    {
+        return std::forward<Element>(element);
+    }
+}
+
+// C++23 std::forward_like: moves a member out only when its owner was an rvalue.
+template<typename Owner, typename Member>
+constexpr decltype(auto) forward_like(Member &member) noexcept
+{
+    if constexpr (std::is_lvalue_reference_v<Owner>)
+    {
+        return static_cast<const Member &>(member);
+    }
+    else
+    {
+        return std::move(member);
+    }
+}
+
+template<template<typename> typename T, typename Func, typename Range>
+concept HasTraitsTraverse = requires(Func &&func, Range &&range) {
+    FunctionalTraits<T>::traverse(std::forward<Func>(func), std::forward<Range>(range));
+};
+
+// Works for any Applicative: the accumulated vector is threaded through fapply by move, so
+// the single reserve up front is the only allocation of the result storage.
+template<template<typename> typename T, typename Value, typename Func, typename Range>
+constexpr auto generic_traverse(Func &&func, Range &&range)
+{
+    std::vector<Value> storage;
+    storage.reserve(reserve_hint(range));
+    auto result = fpure<T>(std::move(storage));
+    constexpr auto append = [] (std::vector<Value> accumulated, Value value) {
+        accumulated.push_back(std::move(value));
+        return accumulated;
+    };
+    for (auto &&element : range)
+    {
+        result = fmap(partially_applicable(append), std::move(result))
+            * std::invoke(func, forward_range_element<Range>(element));
+    }
+    return result;
+}
+
+template<template<typename> typename T, typename Value, typename Func, typename Range>
+constexpr auto traverse_impl(T<Value> *, Func &&func, Range &&range)
+{
+    if constexpr (HasTraitsTraverse<T, Func, Range>)
+    {
+        return FunctionalTraits<T>::traverse(std::forward<Func>(func), std::forward<Range>(range));
+    }
+    else
+    {
+        return generic_traverse<T, Value>(std::forward<Func>(func), std::forward<Range>(range));
+    }
+}
+
+} // namespace detail
+
+// traverse(f, [a, b, ...]) == fmap(to_vector, f(a)) * f(b) * ... for the Applicative that f returns.
+// Instances with a failure state can provide FunctionalTraits<T>::traverse to stop at the first one.
+template<typename Func, std::ranges::input_range Range>
+constexpr auto traverse(Func &&func, Range &&range)
+{
+    using Wrapped = std::remove_cvref_t<std::invoke_result_t<Func &, std::ranges::range_reference_t<Range>>>;
+    return detail::traverse_impl(static_cast<Wrapped *>(nullptr), std::forward<Func>(func), std::forward<Range>(range));
+}
+
+template<std::ranges::input_range Range>
+constexpr auto sequence(Range &&range)
+{
+    constexpr auto forward_element = [] <typename Element> (Element &&element) -> Element && {
+        return std::forward<Element>(element);
+    };
+    return traverse(forward_element, std::forward<Range>(range));
+}
+
+} // namespace functional
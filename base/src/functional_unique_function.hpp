@@ -0,0 +1,239 @@
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+#include <functional>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "functional_monad.hpp"
+
+namespace functional
+{
+
+namespace detail
+{
+
+template<typename R, typename ...Args>
+struct UniqueFunctionOps final
+{
+    R (*invoke)(void *storage, Args &&...args);
+    // Move-constructs the target into destination and ends its lifetime in source.
+    void (*relocate)(void *destination, void *source) noexcept;
+    void (*destroy)(void *storage) noexcept;
+};
+
+// Inline storage needs a nothrow move so that relocating, e.g. when a vector of stages grows, cannot fail.
+template<typename Func, std::size_t InlineBytes>
+constexpr bool is_stored_inline_v = sizeof(Func) <= InlineBytes
+    && alignof(Func) <= alignof(std::max_align_t)
+    && std::is_nothrow_move_constructible_v<Func>;
+
+template<typename Func, bool Inline, typename R, typename ...Args>
+struct UniqueFunctionModel final
+{
+    static Func &target(void *storage) noexcept
+    {
+        if constexpr (Inline)
+        {
+            return *std::launder(static_cast<Func *>(storage));
+        }
+        else
+        {
+            return **static_cast<Func **>(storage);
+        }
+    }
+
+    static R invoke(void *storage, Args &&...args)
+    {
+        if constexpr (std::is_void_v<R>)
+        {
+            std::invoke(target(storage), std::forward<Args>(args)...);
+        }
+        else
+        {
+            return std::invoke(target(storage), std::forward<Args>(args)...);
+        }
+    }
+
+    static void relocate(void *destination, void *source) noexcept
+    {
+        if constexpr (Inline)
+        {
+            ::new (destination) Func(std::move(target(source)));
+            target(source).~Func();
+        }
+        else
+        {
+            *static_cast<Func **>(destination) = *static_cast<Func **>(source);
+        }
+    }
+
+    static void destroy(void *storage) noexcept
+    {
+        if constexpr (Inline)
+        {
+            target(storage).~Func();
+        }
+        else
+        {
+            delete &target(storage);
+        }
+    }
+
+    static constexpr UniqueFunctionOps<R, Args...> ops{&invoke, &relocate, &destroy};
+};
+
+} // namespace detail
+
+template<typename Sig, std::size_t InlineBytes = 4 * sizeof(void *)>
+class UniqueFunction;
+
+// Move-only counterpart of std::function: stores move-only callables, and callables of up to
+// InlineBytes (with a nothrow move) in place instead of on the heap.
+template<typename R, typename ...Args, std::size_t InlineBytes>
+class UniqueFunction<R(Args...), InlineBytes> final
+{
+public:
+    template<typename Func>
+    static constexpr bool is_stored_inline_v = detail::is_stored_inline_v<std::remove_cvref_t<Func>, InlineBytes>;
+
+    UniqueFunction() noexcept = default;
+
+    UniqueFunction(std::nullptr_t) noexcept
+    {
+    }
+
+    template<typename Func>
+        requires (!std::is_same_v<std::remove_cvref_t<Func>, UniqueFunction>
+                  && std::is_constructible_v<std::remove_cvref_t<Func>, Func &&>
+                  && std::is_invocable_r_v<R, std::remove_cvref_t<Func> &, Args...>)
+    UniqueFunction(Func &&func)
+    {
+        using Target = std::remove_cvref_t<Func>;
+        constexpr bool stored_inline = detail::is_stored_inline_v<Target, InlineBytes>;
+        if constexpr (stored_inline)
+        {
+            ::new (static_cast<void *>(storage_)) Target(std::forward<Func>(func));
+        }
+        else
+        {
+            ::new (static_cast<void *>(storage_)) Target *(new Target(std::forward<Func>(func)));
+        }
+        ops_ = &detail::UniqueFunctionModel<Target, stored_inline, R, Args...>::ops;
+    }
+
+    UniqueFunction(UniqueFunction &&other) noexcept
+        : ops_(std::exchange(other.ops_, nullptr))
+    {
+        if (ops_)
+        {
+            ops_->relocate(storage_, other.storage_);
+        }
+    }
+
+    UniqueFunction &operator=(UniqueFunction &&other) noexcept
+    {
+        if (this != &other)
+        {
+            reset();
+            if ((ops_ = std::exchange(other.ops_, nullptr)))
+            {
+                ops_->relocate(storage_, other.storage_);
+            }
+        }
+        return *this;
+    }
+
+    UniqueFunction(const UniqueFunction &) = delete;
+    UniqueFunction &operator=(const UniqueFunction &) = delete;
+
+    ~UniqueFunction()
+    {
+        reset();
+    }
+
+    explicit operator bool() const noexcept
+    {
+        return ops_ != nullptr;
+    }
+
+    R operator()(Args ...args)
+    {
+        assert(ops_ && "calling an empty UniqueFunction");
+        return ops_->invoke(storage_, std::forward<Args>(args)...);
+    }
+
+private:
+    void reset() noexcept
+    {
+        if (ops_)
+        {
+            ops_->destroy(storage_);
+            ops_ = nullptr;
+        }
+    }
+
+    const detail::UniqueFunctionOps<R, Args...> *ops_ = nullptr;
+    alignas(std::max_align_t) std::byte storage_[InlineBytes < sizeof(void *) ? sizeof(void *) : InlineBytes];
+};
+
+// Chain of fmap/fbind stages over T<Value> assembled at runtime. Each stage is a UniqueFunction,
+// so move-only stages are fine and stages whose captures fit InlineBytes are not heap-allocated;
+// the only allocation is the stage vector itself.
+template<template<typename> typename T, typename Value, std::size_t InlineBytes = 4 * sizeof(void *)>
+class DynamicPipeline final
+{
+public:
+    using Stage = UniqueFunction<T<Value>(T<Value> &&), InlineBytes>;
+
+    DynamicPipeline() = default;
+
+    explicit DynamicPipeline(std::size_t expected_stages)
+    {
+        stages_.reserve(expected_stages);
+    }
+
+    // func: Value -> Value
+    template<typename Func>
+    DynamicPipeline &map(Func &&func)
+    {
+        stages_.emplace_back([func = std::forward<Func>(func)] (T<Value> &&input) mutable {
+            using functional::fmap;
+            return fmap(func, std::move(input));
+        });
+        return *this;
+    }
+
+    // func: Value -> T<Value>
+    template<typename Func>
+    DynamicPipeline &bind(Func &&func)
+    {
+        stages_.emplace_back([func = std::forward<Func>(func)] (T<Value> &&input) mutable {
+            using functional::fbind;
+            return fbind(func, std::move(input));
+        });
+        return *this;
+    }
+
+    std::size_t size() const noexcept
+    {
+        return stages_.size();
+    }
+
+    T<Value> run(T<Value> input)
+    {
+        for (Stage &stage : stages_)
+        {
+            input = stage(std::move(input));
+        }
+        return input;
+    }
+
+private:
+    std::vector<Stage> stages_;
+};
+
+} // namespace functional
@@ -0,0 +1,266 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "functional_monad.hpp"
+#include "functional_alternative.hpp"
+#include "functional_parallel.hpp"
+
+namespace functional
+{
+
+// fmap_par maps vectors at least this long on ThreadPool::global(); shorter ones on the caller.
+inline constexpr std::size_t vector_parallel_threshold = 1 << 15;
+
+namespace detail
+{
+
+// Calls body(idx) for every index, on the pool once count reaches vector_parallel_threshold.
+template<typename Body>
+void for_each_index_par(std::size_t count, const Body &body)
+{
+    if (count >= vector_parallel_threshold)
+    {
+        parallel_for(count, body);
+        return;
+    }
+    for (std::size_t idx = 0; idx < count; ++idx)
+    {
+        body(idx);
+    }
+}
+
+template<typename Func, typename Input, typename Arg>
+concept ReusableVectorBuffer = std::is_same_v<std::remove_cvref_t<std::invoke_result_t<Func, Arg>>, Input>
+    && std::is_move_assignable_v<Input>;
+
+} // namespace detail
+
+template<>
+struct FunctionalTraits<std::vector> final
+{
+    template<typename Input>
+    static constexpr auto pure(Input &&input)
+    {
+        std::vector<std::remove_cvref_t<Input>> result;
+        result.reserve(1);
+        result.push_back(std::forward<Input>(input));
+        return result;
+    }
+
+    // Sequential, whatever the size: only fmap_par runs func on several threads.
+    template<typename Func, typename Input>
+    static constexpr auto map(Func &&func, std::vector<Input> &&input)
+    {
+        using FuncRet = std::remove_cvref_t<std::invoke_result_t<Func &, Input &&>>;
+        if constexpr (detail::ReusableVectorBuffer<Func &, Input, Input &&>)
+        {
+            for (auto &value : input)
+            {
+                value = std::invoke(func, std::move(value));
+            }
+            return std::move(input);
+        }
+        else
+        {
+            std::vector<FuncRet> result;
+            result.reserve(input.size());
+            for (auto &value : input)
+            {
+                result.push_back(std::invoke(func, std::move(value)));
+            }
+            return result;
+        }
+    }
+
+    template<typename Func, typename Input>
+    static constexpr auto map(Func &&func, const std::vector<Input> &input)
+    {
+        using FuncRet = std::remove_cvref_t<std::invoke_result_t<Func &, const Input &>>;
+        std::vector<FuncRet> result;
+        result.reserve(input.size());
+        for (const auto &value : input)
+        {
+            result.push_back(std::invoke(func, value));
+        }
+        return result;
+    }
+
+    // Cartesian product: every function is applied to every value, functions in the outer loop.
+    // Move-only values that cannot be shared between functions only support a single function.
+    template<typename Func, typename Input>
+        requires is_instance_v<std::vector, Input>
+    static constexpr auto apply(std::vector<Func> &&func, Input &&input)
+    {
+        return apply_impl(func, std::forward<Input>(input));
+    }
+
+    template<typename Func, typename Input>
+        requires is_instance_v<std::vector, Input>
+    static constexpr auto apply(const std::vector<Func> &func, Input &&input)
+    {
+        return apply_impl(func, std::forward<Input>(input));
+    }
+
+    template<typename Input>
+        requires is_instance_v<std::vector, Input>
+    static constexpr auto join(std::vector<Input> &&input)
+    {
+        Input result;
+        result.reserve(total_size(input));
+        for (auto &inner : input)
+        {
+            result.insert(result.end(), std::make_move_iterator(inner.begin()), std::make_move_iterator(inner.end()));
+        }
+        return result;
+    }
+
+    template<typename Input>
+        requires is_instance_v<std::vector, Input>
+    static constexpr auto join(const std::vector<Input> &input)
+    {
+        Input result;
+        result.reserve(total_size(input));
+        for (const auto &inner : input)
+        {
+            result.insert(result.end(), inner.begin(), inner.end());
+        }
+        return result;
+    }
+
+    template<typename InputLeft, typename InputRight>
+        requires std::same_as<std::vector<InputLeft>, std::remove_cvref_t<InputRight>>
+    static constexpr auto alternate(std::vector<InputLeft> &&lhs, InputRight &&rhs)
+    {
+        append(lhs, std::forward<InputRight>(rhs));
+        return std::move(lhs);
+    }
+
+    template<typename InputLeft, typename InputRight>
+        requires std::same_as<std::vector<InputLeft>, std::remove_cvref_t<InputRight>>
+    static constexpr auto alternate(const std::vector<InputLeft> &lhs, InputRight &&rhs)
+    {
+        std::vector<InputLeft> result;
+        result.reserve(lhs.size() + rhs.size());
+        result.insert(result.end(), lhs.begin(), lhs.end());
+        append(result, std::forward<InputRight>(rhs));
+        return result;
+    }
+
+private:
+    template<typename FuncVector, typename Input>
+    static constexpr auto apply_impl(FuncVector &func, Input &&input)
+    {
+        using Func = decltype(*func.begin());
+        using Value = typename std::remove_cvref_t<Input>::value_type;
+        using FuncRet = std::remove_cvref_t<decltype(map(std::declval<Func>(), std::forward<Input>(input)))>;
+        if (func.size() == 1)
+        {
+            return map(func.front(), std::forward<Input>(input));
+        }
+        FuncRet result;
+        if constexpr (std::is_invocable_v<Func, const Value &>)
+        {
+            result.reserve(func.size() * input.size());
+            for (auto &wrapped_func : func)
+            {
+                for (const auto &value : input)
+                {
+                    result.push_back(std::invoke(wrapped_func, value));
+                }
+            }
+        }
+        else if constexpr (std::is_copy_constructible_v<Value>)
+        {
+            result.reserve(func.size() * input.size());
+            for (auto &wrapped_func : func)
+            {
+                for (const auto &value : input)
+                {
+                    result.push_back(std::invoke(wrapped_func, Value(value)));
+                }
+            }
+        }
+        else if (!func.empty())
+        {
+            throw std::invalid_argument("move-only vector values can be consumed by a single function only");
+        }
+        return result;
+    }
+
+    template<typename Input>
+    static constexpr std::size_t total_size(const std::vector<Input> &input) noexcept
+    {
+        std::size_t size = 0;
+        for (const auto &inner : input)
+        {
+            size += inner.size();
+        }
+        return size;
+    }
+
+    template<typename Value, typename InputRight>
+    static constexpr void append(std::vector<Value> &lhs, InputRight &&rhs)
+    {
+        if constexpr (std::is_rvalue_reference_v<InputRight &&>)
+        {
+            lhs.insert(lhs.end(), std::make_move_iterator(rhs.begin()), std::make_move_iterator(rhs.end()));
+        }
+        else
+        {
+            lhs.insert(lhs.end(), rhs.begin(), rhs.end());
+        }
+    }
+};
+
+// Opt-in parallel fmap for vectors: func is called concurrently from ThreadPool::global() workers,
+// so it must be safe to call that way; a callable with unsynchronized side effects belongs in
+// fmap. func is always called as const, on every element and at every size, so the overload it
+// picks does not depend on the input. Results need a default constructor unless they replace
+// the input elements in place.
+template<typename Func, typename Input>
+    requires std::is_invocable_v<const Func &, Input &&>
+auto fmap_par(const Func &func, std::vector<Input> &&input)
+{
+    using FuncRet = std::remove_cvref_t<std::invoke_result_t<const Func &, Input &&>>;
+    if constexpr (detail::ReusableVectorBuffer<const Func &, Input, Input &&>)
+    {
+        const auto map_one = [&func, &input] (std::size_t idx) {
+            input[idx] = std::invoke(func, std::move(input[idx]));
+        };
+        detail::for_each_index_par(input.size(), map_one);
+        return std::move(input);
+    }
+    else
+    {
+        static_assert(std::is_default_constructible_v<FuncRet>, "fmap_par writes results into a pre-sized vector");
+        std::vector<FuncRet> result(input.size());
+        const auto map_one = [&func, &input, &result] (std::size_t idx) {
+            result[idx] = std::invoke(func, std::move(input[idx]));
+        };
+        detail::for_each_index_par(input.size(), map_one);
+        return result;
+    }
+}
+
+template<typename Func, typename Input>
+    requires std::is_invocable_v<const Func &, const Input &>
+auto fmap_par(const Func &func, const std::vector<Input> &input)
+{
+    using FuncRet = std::remove_cvref_t<std::invoke_result_t<const Func &, const Input &>>;
+    static_assert(std::is_default_constructible_v<FuncRet>, "fmap_par writes results into a pre-sized vector");
+    std::vector<FuncRet> result(input.size());
+    const auto map_one = [&func, &input, &result] (std::size_t idx) {
+        result[idx] = std::invoke(func, input[idx]);
+    };
+    detail::for_each_index_par(input.size(), map_one);
+    return result;
+}
+
+} // namespace functional
@@ -3,7 +3,14 @@
 #include "functional_applicative.hpp"
 #include "functional_alternative.hpp"
 #include "functional_traits.hpp"
+#include "functional_traverse.hpp"
+#include "functional_reader.hpp"
 
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <ranges>
 #include <string_view>
 #include <type_traits>
 #include <utility>
@@ -47,7 +54,7 @@ using NotParsed = std::monostate;
 template<typename ...Args>
 struct overloaded_t : Args...
 {
-    explicit overloaded_t(Args ...args)
+    explicit constexpr overloaded_t(Args ...args)
         : Args(std::move(args))...
     {
     }
@@ -92,95 +99,397 @@ struct Parser final
     std::string error_suffix;
 };
 
-template<typename Func>
-    requires (std::is_invocable_v<const Func &, const JsonObject &>
-              && functional::is_instance_v<Parser, std::invoke_result_t<const Func &, const JsonObject &>>)
-consteval auto with_object(std::string_view class_name_sv, Func &&func)
+// Instrumentation policy of with_object/with_string/with_list/with_number/parse_field. The
+// default compiles the hooks out; json_instrumentation.hpp provides a recording policy.
+struct NoInstrumentation final
+{
+    static constexpr bool enabled = false;
+};
+
+namespace detail
+{
+
+template<typename Instrumentation, typename Callable>
+constexpr auto instrumented(std::string_view kind, std::string_view name, Callable &&callable)
+{
+    if constexpr (Instrumentation::enabled)
+    {
+        const auto start = std::chrono::steady_clock::now();
+        auto result = std::forward<Callable>(callable)();
+        Instrumentation::record(kind, name, std::holds_alternative<ParseError>(result.value), std::chrono::steady_clock::now() - start);
+        return result;
+    }
+    else
+    {
+        return std::forward<Callable>(callable)();
+    }
+}
+
+// FNV-1a of an object key; constexpr so that key tables can be hashed at compile time.
+constexpr std::uint64_t hash_key(std::string_view key) noexcept
+{
+    std::uint64_t hash = 0xcbf2'9ce4'8422'2325;
+    for (const char character : key)
+    {
+        hash = (hash ^ static_cast<unsigned char>(character)) * 0x0000'0100'0000'01b3;
+    }
+    return hash;
+}
+
+// Free lists behind json::ParseContext. While a context parses on a thread, the combinators take
+// error strings and list results from the active recycler and give consumed strings back, so that
+// a steady-state parse loop reuses buffers instead of allocating. Without one, nothing changes.
+class Recycler final
+{
+public:
+    std::string acquire_string() noexcept
+    {
+        if (strings_.empty())
+        {
+            return {};
+        }
+        std::string string = std::move(strings_.back());
+        strings_.pop_back();
+        return string;
+    }
+
+    void release_string(std::string &&string)
+    {
+        if (string.capacity() > std::string{}.capacity())
+        {
+            string.clear();
+            strings_.push_back(std::move(string));
+        }
+    }
+
+    template<typename T>
+    std::vector<T> acquire_vector()
+    {
+        auto &vectors = pool<T>();
+        if (vectors.empty())
+        {
+            return {};
+        }
+        std::vector<T> vector = std::move(vectors.back());
+        vectors.pop_back();
+        return vector;
+    }
+
+    template<typename T>
+    void release_vector(std::vector<T> &&vector)
+    {
+        if (vector.capacity() > 0)
+        {
+            vector.clear();
+            pool<T>().push_back(std::move(vector));
+        }
+    }
+
+private:
+    struct PoolBase
+    {
+        virtual ~PoolBase() = default;
+    };
+
+    template<typename T>
+    struct Pool final : PoolBase
+    {
+        std::vector<std::vector<T>> vectors;
+    };
+
+    static std::size_t next_type_slot() noexcept
+    {
+        static std::atomic<std::size_t> next{0};
+        return next.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    // Dense per-type index, so that finding a pool is one vector access instead of a hash lookup.
+    template<typename T>
+    static std::size_t type_slot() noexcept
+    {
+        static const std::size_t slot = next_type_slot();
+        return slot;
+    }
+
+    template<typename T>
+    std::vector<std::vector<T>> &pool()
+    {
+        const std::size_t slot = type_slot<T>();
+        if (slot >= pools_.size())
+        {
+            pools_.resize(slot + 1);
+        }
+        if (!pools_[slot])
+        {
+            pools_[slot] = std::make_unique<Pool<T>>();
+        }
+        return static_cast<Pool<T> &>(*pools_[slot]).vectors;
+    }
+
+    std::vector<std::string> strings_;
+    std::vector<std::unique_ptr<PoolBase>> pools_;
+};
+
+inline thread_local Recycler *active_recycler = nullptr;
+
+// Concatenation of parts (anything convertible to std::string_view) for an error message.
+template<typename ...Parts>
+constexpr std::string error_string(const Parts &...parts)
+{
+    std::string result;
+    if (!std::is_constant_evaluated() && active_recycler)
+    {
+        result = active_recycler->acquire_string();
+    }
+    result.reserve((std::string_view{parts}.size() + ...));
+    (result.append(std::string_view{parts}), ...);
+    return result;
+}
+
+constexpr void release_string(std::string &&string)
+{
+    if (!std::is_constant_evaluated() && active_recycler)
+    {
+        active_recycler->release_string(std::move(string));
+    }
+}
+
+// Prepends parts to an error prefix.
+template<typename ...Parts>
+constexpr void prepend_error(std::string &prefix, const Parts &...parts)
+{
+    std::string joined = error_string(parts..., prefix);
+    release_string(std::move(prefix));
+    prefix = std::move(joined);
+}
+
+// The rendered message of a failed parser, as passed on by fmap/fapply: "prefix message suffix".
+constexpr std::string joined_error(std::string &&prefix, std::string &&message, std::string &&suffix)
+{
+    if (prefix.capacity() == std::string{}.capacity() && !std::is_constant_evaluated() && active_recycler)
+    {
+        prefix = active_recycler->acquire_string();
+    }
+    prefix.reserve(prefix.size() + message.size() + suffix.size() + 2);
+    prefix.append(" ").append(message).append(" ").append(suffix);
+    release_string(std::move(message));
+    release_string(std::move(suffix));
+    return std::move(prefix);
+}
+
+template<typename T>
+constexpr std::vector<T> acquire_vector()
+{
+    if (!std::is_constant_evaluated() && active_recycler)
+    {
+        return active_recycler->acquire_vector<T>();
+    }
+    return {};
+}
+
+template<typename T>
+constexpr void release_vector(std::vector<T> &&vector)
+{
+    if (!std::is_constant_evaluated() && active_recycler)
+    {
+        active_recycler->release_vector(std::move(vector));
+    }
+}
+
+} // namespace detail
+
+} // namespace json
+
+namespace functional
+{
+
+template<>
+struct FunctionalTraits<json::Parser> final
+{
+    // Stops at the first element that did not parse and reports its index.
+    template<typename Func, typename Range>
+    static constexpr auto traverse(Func &&func, Range &&range)
+    {
+        using Wrapped = std::remove_cvref_t<std::invoke_result_t<Func &, std::ranges::range_reference_t<Range>>>;
+        using Value = std::remove_cvref_t<decltype(std::get<1>(std::declval<Wrapped>().value))>;
+        using Result = json::Parser<std::vector<Value>>;
+        std::vector<Value> result = json::detail::acquire_vector<Value>();
+        result.reserve(detail::reserve_hint(range));
+        std::size_t idx = 0;
+        for (auto &&element : range)
+        {
+            auto &&wrapped = std::invoke(func, detail::forward_range_element<Range>(element));
+            if (auto *value = std::get_if<Value>(&wrapped.value))
+            {
+                result.push_back(detail::forward_like<decltype(wrapped)>(*value));
+            }
+            else if (auto *parse_error = std::get_if<json::ParseError>(&wrapped.value))
+            {
+                json::detail::release_vector(std::move(result));
+                std::string error_prefix = detail::forward_like<decltype(wrapped)>(wrapped.error_prefix);
+                json::detail::prepend_error(error_prefix, "When parsing element ", std::to_string(idx), ": ");
+                return Result{
+                    detail::forward_like<decltype(wrapped)>(*parse_error),
+                    std::move(error_prefix),
+                    detail::forward_like<decltype(wrapped)>(wrapped.error_suffix),
+                };
+            }
+            else
+            {
+                return fempty<json::Parser, std::vector<Value>>();
+            }
+            ++idx;
+        }
+        return Result{std::move(result)};
+    }
+};
+
+} // namespace functional
+
+namespace json
+{
+
+namespace detail
+{
+
+template<typename Instrumentation, typename Func>
+constexpr auto with_object_impl(std::string_view class_name, const Func &func, const JsonValue &json_value)
+    noexcept(std::is_nothrow_invocable_v<const Func &, const JsonObject &>)
 {
     using RetVal = std::remove_cvref_t<std::invoke_result_t<const Func &, const JsonObject &>>;
-    return [forwarded_func = std::forward<Func>(func), class_name = class_name_sv] (const JsonValue &json_value) noexcept(std::is_nothrow_invocable_v<const Func &, const JsonObject &>) {
+    return instrumented<Instrumentation>("with_object", class_name, [&] {
         return visit(
-                overloaded([&class_name, &forwarded_func] (const JsonObject &json_object) {
-                               auto func_result = forwarded_func(json_object);
-                               using namespace std::literals;
-                               func_result.error_prefix = "When parsing JSON object for "s + std::string(class_name) + ": " + std::move(func_result.error_prefix);
+                overloaded([&class_name, &func] (const JsonObject &json_object) {
+                               auto func_result = func(json_object);
+                               if (std::holds_alternative<ParseError>(func_result.value))
+                               {
+                                   prepend_error(func_result.error_prefix, "When parsing JSON object for ", class_name, ": ");
+                               }
                                return func_result;
                            },
                            [&class_name] (const auto &) {
                                return RetVal{ParseError{
-                                   "Expected JSON object for " + std::string(class_name)
+                                   detail::error_string("Expected JSON object for ", class_name)
                                }};
                            }),
                 json_value);
+    });
+}
+
+} // namespace detail
+
+template<typename Instrumentation = NoInstrumentation, typename Func>
+    requires (std::is_invocable_v<const Func &, const JsonObject &>
+              && functional::is_instance_v<Parser, std::invoke_result_t<const Func &, const JsonObject &>>)
+consteval auto with_object(std::string_view class_name_sv, Func &&func)
+{
+    return [forwarded_func = std::forward<Func>(func), class_name = class_name_sv] (const JsonValue &json_value) noexcept(std::is_nothrow_invocable_v<const Func &, const JsonObject &>) {
+        return detail::with_object_impl<Instrumentation>(class_name, forwarded_func, json_value);
+    };
+}
+
+// with_object for context-dependent parsing: func is `(const Env &, const JsonObject &) -> Parser<T>`
+// and the parser returns a functional::Reader, so the environment (arena, options, ...) reaches
+// nested parsers through run()/asks()/fbind instead of globals or an extra argument on every
+// combinator. The Reader refers to json_value, so run it while the value is alive.
+// Env is only known once the Reader runs, so func is checked against it there, through the same
+// constraint with_object puts on its callable.
+template<typename Instrumentation = NoInstrumentation, typename Func>
+    requires std::is_copy_constructible_v<std::remove_cvref_t<Func>>
+consteval auto with_object_in(std::string_view class_name_sv, Func &&func)
+{
+    return [forwarded_func = std::forward<Func>(func), class_name = class_name_sv] (const JsonValue &json_value) {
+        return functional::Reader{[func = forwarded_func, class_name, &json_value] <typename Env> (const Env &env)
+                                      requires (std::is_invocable_v<const std::remove_cvref_t<Func> &, const Env &, const JsonObject &>
+                                                && functional::is_instance_v<Parser, std::invoke_result_t<const std::remove_cvref_t<Func> &, const Env &, const JsonObject &>>) {
+            return detail::with_object_impl<Instrumentation>(
+                    class_name,
+                    [&func, &env] (const JsonObject &json_object) {
+                        return func(env, json_object);
+                    },
+                    json_value);
+        }};
     };
 }
 
-template<typename Func>
+template<typename Instrumentation = NoInstrumentation, typename Func>
     requires (std::is_invocable_v<const Func &, const JsonString &>
               && functional::is_instance_v<Parser, std::invoke_result_t<const Func &, const JsonString &>>)
 consteval auto with_string(std::string_view class_name_sv, Func &&func)
 {
     using RetVal = std::remove_cvref_t<std::invoke_result_t<const Func &, const JsonString &>>;
     return [forwarded_func = std::forward<Func>(func), class_name = class_name_sv] (const JsonValue &json_value) noexcept(std::is_nothrow_invocable_v<const Func &, const JsonString &>) {
-        return visit(
-                overloaded([&class_name, &forwarded_func] (const JsonString &json_string) {
-                               auto func_result = forwarded_func(json_string);
-                               using namespace std::literals;
-                               func_result.error_prefix = "When parsing JSON string for "s + std::string(class_name) + ": " + std::move(func_result.error_prefix);
-                               return func_result;
-                           },
-                           [&class_name] (const auto &) {
-                               return RetVal{ParseError{
-                                   "Expected JSON string for " + std::string(class_name)
-                               }};
-                           }),
-                json_value);
+        return detail::instrumented<Instrumentation>("with_string", class_name, [&] {
+            return visit(
+                    overloaded([&class_name, &forwarded_func] (const JsonString &json_string) {
+                                   auto func_result = forwarded_func(json_string);
+                                   if (std::holds_alternative<ParseError>(func_result.value))
+                                   {
+                                       detail::prepend_error(func_result.error_prefix, "When parsing JSON string for ", class_name, ": ");
+                                   }
+                                   return func_result;
+                               },
+                               [&class_name] (const auto &) {
+                                   return RetVal{ParseError{
+                                       detail::error_string("Expected JSON string for ", class_name)
+                                   }};
+                               }),
+                    json_value);
+        });
     };
 }
 
-template<typename Func>
+template<typename Instrumentation = NoInstrumentation, typename Func>
     requires (std::is_invocable_v<const Func &, const JsonList &>
               && functional::is_instance_v<Parser, std::invoke_result_t<const Func &, const JsonList &>>)
 consteval auto with_list(std::string_view class_name_sv, Func &&func)
 {
     using RetVal = std::remove_cvref_t<std::invoke_result_t<const Func &, const JsonList &>>;
     return [forwarded_func = std::forward<Func>(func), class_name = class_name_sv] (const JsonValue &json_value) noexcept(std::is_nothrow_invocable_v<const Func &, const JsonList &>) {
-        return std::visit(
-                overloaded([&class_name, &forwarded_func] (const JsonList &json_list) {
-                               auto func_result = forwarded_func(json_list);
-                               using namespace std::literals;
-                               func_result.error_prefix = "When parsing JSON list for "s + std::string(class_name) + ": " + std::move(func_result.error_prefix);
-                               return func_result;
-                           },
-                           [&class_name] (const auto &) {
-                               return RetVal{ParseError{
-                                   "Expected JSON list for " + std::string(class_name)
-                               }};
-                           }),
-                json_value);
+        return detail::instrumented<Instrumentation>("with_list", class_name, [&] {
+            return visit(
+                    overloaded([&class_name, &forwarded_func] (const JsonList &json_list) {
+                                   auto func_result = forwarded_func(json_list);
+                                   if (std::holds_alternative<ParseError>(func_result.value))
+                                   {
+                                       detail::prepend_error(func_result.error_prefix, "When parsing JSON list for ", class_name, ": ");
+                                   }
+                                   return func_result;
+                               },
+                               [&class_name] (const auto &) {
+                                   return RetVal{ParseError{
+                                       detail::error_string("Expected JSON list for ", class_name)
+                                   }};
+                               }),
+                    json_value);
+        });
     };
 }
 
-template<typename Func>
+template<typename Instrumentation = NoInstrumentation, typename Func>
     requires (std::is_invocable_v<const Func &, const JsonNumber &>
               && functional::is_instance_v<Parser, std::invoke_result_t<const Func &, JsonNumber>>)
 consteval auto with_number(std::string_view class_name_sv, Func &&func)
 {
     using RetVal = std::remove_cvref_t<std::invoke_result_t<const Func &, JsonNumber>>;
     return [forwarded_func = std::forward<Func>(func), class_name = class_name_sv] (const JsonValue &json_value) noexcept(std::is_nothrow_invocable_v<const Func &, JsonNumber>) {
-        return visit(
-                overloaded([&class_name, &forwarded_func] (const JsonNumber json_number) {
-                               auto func_result = forwarded_func(json_number);
-                               using namespace std::literals;
-                               func_result.error_prefix = "When parsing JSON number for "s + std::string(class_name) + ": " + std::move(func_result.error_prefix);
-                               return func_result;
-                           },
-                           [&class_name] (const auto &) {
-                               return RetVal{ParseError{
-                                   "Expected JSON number for " + std::string(class_name)
-                               }};
-                           }),
-                json_value);
+        return detail::instrumented<Instrumentation>("with_number", class_name, [&] {
+            return visit(
+                    overloaded([&class_name, &forwarded_func] (const JsonNumber json_number) {
+                                   auto func_result = forwarded_func(json_number);
+                                   if (std::holds_alternative<ParseError>(func_result.value))
+                                   {
+                                       detail::prepend_error(func_result.error_prefix, "When parsing JSON number for ", class_name, ": ");
+                                   }
+                                   return func_result;
+                               },
+                               [&class_name] (const auto &) {
+                                   return RetVal{ParseError{
+                                       detail::error_string("Expected JSON number for ", class_name)
+                                   }};
+                               }),
+                    json_value);
+        });
     };
 }
 
@@ -211,10 +520,12 @@ constexpr auto json_type_parser()
     }
 }
 
+namespace detail
+{
+
 template<typename FieldType>
-constexpr Parser<FieldType> parse_field(const JsonObject &object, std::string_view field_name)
+constexpr Parser<FieldType> parse_field_impl(const JsonObject &object, std::string_view field_name)
 {
-    using namespace std::literals;
     const auto found_element = std::find_if(begin(object), end(object), [field_name] (const auto &field) {
                                                 return field.first == field_name;
                                             });
@@ -222,14 +533,37 @@ constexpr Parser<FieldType> parse_field(const JsonObject &object, std::string_vi
     {
         constexpr auto parser_func = json_type_parser<FieldType>();
         auto func_result = parser_func(found_element->second);
-        func_result.error_prefix = "When parsing JSON object field \""s + std::string(field_name) + "\": " + std::move(func_result.error_prefix);
+        // The prefix is only ever rendered for errors, so the success path does not build it.
+        if (std::holds_alternative<ParseError>(func_result.value))
+        {
+            prepend_error(func_result.error_prefix, "When parsing JSON object field \"", field_name, "\": ");
+        }
         return func_result;
     }
     return Parser<FieldType>{ParseError{
-        "Expected JSON object field \""s + std::string(field_name) + "\""
+        error_string("Expected JSON object field \"", field_name, "\"")
     }};
 }
 
+} // namespace detail
+
+// As with the other combinators the policy comes first: `parse_field<json::Instrumented, JsonNumber>(...)`.
+// FieldType cannot be deduced, so the uninstrumented `parse_field<JsonNumber>(...)` is an overload.
+template<typename Instrumentation, typename FieldType>
+    requires std::is_same_v<decltype(Instrumentation::enabled), const bool>
+constexpr Parser<FieldType> parse_field(const JsonObject &object, std::string_view field_name)
+{
+    return detail::instrumented<Instrumentation>("parse_field", field_name, [&] {
+        return detail::parse_field_impl<FieldType>(object, field_name);
+    });
+}
+
+template<typename FieldType>
+constexpr Parser<FieldType> parse_field(const JsonObject &object, std::string_view field_name)
+{
+    return parse_field<NoInstrumentation, FieldType>(object, field_name);
+}
+
 template<typename Func, typename T>
 constexpr auto fmap(Func &&func, Parser<T> &&value)
 {
@@ -244,9 +578,7 @@ constexpr auto fmap(Func &&func, Parser<T> &&value)
                        [&error_prefix = value.error_prefix, &error_suffix = value.error_suffix] (ParseError &&parse_error) {
                            return Parser<OutputType>{
                                ParseError{
-                                   .error_message = std::move(error_prefix)
-                                       + " " + std::move(parse_error.error_message)
-                                       + " " + std::move(error_suffix)
+                                   .error_message = detail::joined_error(std::move(error_prefix), std::move(parse_error.error_message), std::move(error_suffix))
                                }
                            };
                        }),
@@ -267,9 +599,7 @@ constexpr auto fmap(Func &&func, const Parser<T> &value)
                        [&error_prefix = value.error_prefix, &error_suffix = value.error_suffix] (const ParseError &parse_error) {
                            return Parser<OutputType>{
                                ParseError{
-                                   .error_message = error_prefix
-                                       + " " + parse_error.error_message
-                                       + " " + error_suffix
+                                   .error_message = detail::error_string(error_prefix, " ", parse_error.error_message, " ", error_suffix)
                                }
                            };
                        }),
@@ -291,9 +621,7 @@ constexpr auto fapply(Parser<Func> &&func, ParserT &&value)
                        [&error_prefix = func.error_prefix, &error_suffix = func.error_suffix] (ParseError &&parse_error) {
                            return OutputType{
                                ParseError{
-                                   .error_message = std::move(error_prefix)
-                                       + " " + std::move(parse_error.error_message)
-                                       + " " + std::move(error_suffix)
+                                   .error_message = detail::joined_error(std::move(error_prefix), std::move(parse_error.error_message), std::move(error_suffix))
                                }
                            };
                        }),
@@ -315,9 +643,7 @@ constexpr auto fapply(const Parser<Func> &func, ParserT &&value)
                        [&error_prefix = func.error_prefix, &error_suffix = func.error_suffix] (const ParseError &parse_error) {
                            return OutputType{
                                ParseError{
-                                   .error_message = error_prefix
-                                       + " " + parse_error.error_message
-                                       + " " + error_suffix
+                                   .error_message = detail::error_string(error_prefix, " ", parse_error.error_message, " ", error_suffix)
                                }
                            };
                        }),
@@ -0,0 +1,321 @@
+#pragma once
+
+#include "json.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <ranges>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <variant>
+#include <vector>
+
+namespace json
+{
+
+// 128-bit content hash of a document. The hash has no secret, so colliding documents can be built
+// on purpose; CachedParser uses it to find candidates and confirms them with same_content().
+struct ContentHash final
+{
+    std::uint64_t low = 0;
+    std::uint64_t high = 0;
+
+    friend constexpr bool operator==(const ContentHash &, const ContentHash &) noexcept = default;
+};
+
+namespace detail
+{
+
+// Two lanes of the xxh3/wyhash style 64x64->128 multiply-fold, one 8-byte word at a time. Every
+// word is keyed by what it encodes, so a value costs a single word and different structures with
+// the same words still hash differently.
+class ContentHasher final
+{
+public:
+    enum Tag : std::size_t
+    {
+        object_size,
+        string_size,
+        number,
+        list_size,
+        bytes,
+    };
+
+    void add(std::uint64_t word, Tag tag) noexcept
+    {
+        static constexpr std::uint64_t low_keys[] = {
+            0xa076'1d64'78bd'642f, 0xe703'7ed1'a0b4'28db, 0x8ebc'6af0'9c88'c6e3, 0x5899'65cc'7537'4cc3, 0x1d8e'4e27'c47d'124f,
+        };
+        static constexpr std::uint64_t high_keys[] = {
+            0x9e37'79b9'7f4a'7c15, 0xc2b2'ae3d'27d4'eb4f, 0x1656'67b1'9e37'79f9, 0xd6e8'feb8'6659'fd93, 0xff51'afd7'ed55'8ccd,
+        };
+        // The multiplies do not depend on the running state, only the rotate and xor do, so
+        // consecutive words are mixed in parallel.
+        low_ = std::rotl(low_, 23) ^ mix(word ^ low_keys[tag], 0xbf58'476d'1ce4'e5b9);
+        high_ = std::rotl(high_, 41) ^ mix(word ^ high_keys[tag], 0x94d0'49bb'1331'11eb);
+    }
+
+    void add(std::string_view string) noexcept
+    {
+        add(string.size(), string_size);
+        std::size_t offset = 0;
+        for (; offset + sizeof(std::uint64_t) <= string.size(); offset += sizeof(std::uint64_t))
+        {
+            std::uint64_t word;
+            std::memcpy(&word, string.data() + offset, sizeof(word));
+            add(word, bytes);
+        }
+        if (offset < string.size())
+        {
+            std::uint64_t word = 0;
+            std::memcpy(&word, string.data() + offset, string.size() - offset);
+            add(word, bytes);
+        }
+    }
+
+    void add(const JsonValue &json_value) noexcept
+    {
+        if (const auto *json_object = std::get_if<JsonObject>(&json_value.value))
+        {
+            add(json_object->size(), object_size);
+            for (const auto &[key, value] : *json_object)
+            {
+                add(std::string_view{key});
+                add(value);
+            }
+        }
+        else if (const auto *json_string = std::get_if<JsonString>(&json_value.value))
+        {
+            add(std::string_view{*json_string});
+        }
+        else if (const auto *json_number = std::get_if<JsonNumber>(&json_value.value))
+        {
+            // 0.0 and -0.0 are the same JSON number.
+            add(std::bit_cast<std::uint64_t>(*json_number == 0 ? 0.0 : *json_number), number);
+        }
+        else if (const auto *json_list = std::get_if<JsonList>(&json_value.value))
+        {
+            add(json_list->size(), list_size);
+            for (const JsonValue &value : *json_list)
+            {
+                add(value);
+            }
+        }
+    }
+
+    ContentHash finish() const noexcept
+    {
+        return {mix(low_ ^ 0x8ebc'6af0'9c88'c6e3, high_ ^ 0x5899'65cc'7537'4cc3), mix(high_ ^ 0x2d35'8dcc'aa6c'78a5, low_ ^ 0x8bb8'4b93'962e'acc9)};
+    }
+
+private:
+    static std::uint64_t mix(std::uint64_t lhs, std::uint64_t rhs) noexcept
+    {
+        const unsigned __int128 product = static_cast<unsigned __int128>(lhs) * rhs;
+        return static_cast<std::uint64_t>(product) ^ static_cast<std::uint64_t>(product >> 64);
+    }
+
+    std::uint64_t low_ = 0x2d35'8dcc'aa6c'78a5;
+    std::uint64_t high_ = 0x8bb8'4b93'962e'acc9;
+};
+
+} // namespace detail
+
+inline ContentHash content_hash(const JsonValue &json_value) noexcept
+{
+    detail::ContentHasher hasher;
+    hasher.add(json_value);
+    return hasher.finish();
+}
+
+// The equality content_hash stands for: same structure, same keys in the same order, and numbers
+// equal as values, so 0.0 and -0.0 are the same.
+inline bool same_content(const JsonValue &lhs, const JsonValue &rhs) noexcept
+{
+    if (lhs.value.index() != rhs.value.index())
+    {
+        return false;
+    }
+    if (const auto *lhs_object = std::get_if<JsonObject>(&lhs.value))
+    {
+        const auto &rhs_object = std::get<JsonObject>(rhs.value);
+        return std::ranges::equal(*lhs_object, rhs_object, [] (const auto &lhs_field, const auto &rhs_field) {
+            return lhs_field.first == rhs_field.first && same_content(lhs_field.second, rhs_field.second);
+        });
+    }
+    if (const auto *lhs_list = std::get_if<JsonList>(&lhs.value))
+    {
+        return std::ranges::equal(*lhs_list, std::get<JsonList>(rhs.value), [] (const JsonValue &lhs_value, const JsonValue &rhs_value) {
+            return same_content(lhs_value, rhs_value);
+        });
+    }
+    if (const auto *lhs_string = std::get_if<JsonString>(&lhs.value))
+    {
+        return *lhs_string == std::get<JsonString>(rhs.value);
+    }
+    return std::get<JsonNumber>(lhs.value) == std::get<JsonNumber>(rhs.value);
+}
+
+struct CacheOptions final
+{
+    // Total number of results kept, split evenly over the shards.
+    std::size_t capacity = 1024;
+    // Rounded up to a power of two; every shard has its own lock and LRU list.
+    std::size_t shards = 16;
+    // Finds the candidate entry of a document. Candidates are confirmed with same_content(), so a
+    // cheaper key than the full content hash, e.g. one the caller already has, only costs
+    // collisions, never wrong results.
+    ContentHash (*hash)(const JsonValue &) = content_hash;
+};
+
+struct CacheStats final
+{
+    std::uint64_t hits = 0;
+    std::uint64_t misses = 0;
+    std::uint64_t evictions = 0;
+    std::size_t size = 0;
+};
+
+// Memoizes a parser by document content: identical documents are parsed once and then share one
+// immutable result, errors included. Every entry keeps a copy of its document and a hit compares
+// it with same_content(), so a result is only ever returned for an equal document, even when
+// documents are built to collide on the hash; a colliding document is parsed and not cached.
+//
+// A hit walks the document twice, once to hash it and once to compare it, so it is not free: for
+// the two-field Point parser of benchmark.cpp a hit costs about as much as parsing 1 point and
+// 55-80% of parsing 16 or 256, depending on the run. The cache pays off for parsers that do more per value than that
+// walk (validation, nested decoders, allocating results) or when the shared result is the point.
+//
+// Safe to call from several threads; a hit takes one shard lock and does not allocate. Parsing
+// on a miss happens outside the lock, so two threads missing on the same document may both parse
+// it, and the first result to be inserted wins.
+template<typename T, typename Func = Parser<T> (*)(const JsonValue &)>
+class CachedParser final
+{
+public:
+    using Result = std::shared_ptr<const Parser<T>>;
+
+    explicit CachedParser(Func parser, CacheOptions options = {})
+        : parser_(std::move(parser))
+        , hash_(options.hash)
+        , shards_(std::bit_ceil(std::max<std::size_t>(options.shards, 1)))
+        , shard_capacity_(std::max<std::size_t>((options.capacity + shards_.size() - 1) / shards_.size(), 1))
+    {
+        for (Shard &shard : shards_)
+        {
+            shard.index.reserve(shard_capacity_);
+        }
+    }
+
+    CachedParser(const CachedParser &) = delete;
+    CachedParser &operator=(const CachedParser &) = delete;
+
+    Result operator()(const JsonValue &json_value)
+    {
+        const ContentHash key = hash_(json_value);
+        Shard &shard = shards_[key.high & (shards_.size() - 1)];
+        {
+            std::lock_guard lock{shard.mutex};
+            if (const auto found = shard.index.find(key); found != shard.index.end() && same_content(found->second->document, json_value))
+            {
+                shard.lru.splice(shard.lru.begin(), shard.lru, found->second);
+                hits_.fetch_add(1, std::memory_order_relaxed);
+                return found->second->result;
+            }
+        }
+        misses_.fetch_add(1, std::memory_order_relaxed);
+        Result result = std::make_shared<const Parser<T>>(std::invoke(parser_, json_value));
+        JsonValue document = json_value;
+
+        std::lock_guard lock{shard.mutex};
+        if (const auto found = shard.index.find(key); found != shard.index.end())
+        {
+            // Either another thread inserted the same document, or a different one collides.
+            return same_content(found->second->document, json_value) ? found->second->result : result;
+        }
+        if (shard.index.size() >= shard_capacity_)
+        {
+            shard.index.erase(shard.lru.back().key);
+            shard.lru.pop_back();
+            evictions_.fetch_add(1, std::memory_order_relaxed);
+        }
+        shard.lru.push_front(Entry{key, std::move(document), result});
+        shard.index.emplace(key, shard.lru.begin());
+        return result;
+    }
+
+    CacheStats stats() const
+    {
+        CacheStats stats{
+            .hits = hits_.load(std::memory_order_relaxed),
+            .misses = misses_.load(std::memory_order_relaxed),
+            .evictions = evictions_.load(std::memory_order_relaxed),
+        };
+        for (const Shard &shard : shards_)
+        {
+            std::lock_guard lock{shard.mutex};
+            stats.size += shard.index.size();
+        }
+        return stats;
+    }
+
+    void clear()
+    {
+        for (Shard &shard : shards_)
+        {
+            std::lock_guard lock{shard.mutex};
+            shard.index.clear();
+            shard.lru.clear();
+        }
+    }
+
+private:
+    struct Entry final
+    {
+        ContentHash key;
+        JsonValue document;
+        Result result;
+    };
+
+    struct KeyHash final
+    {
+        std::size_t operator()(const ContentHash &key) const noexcept
+        {
+            return static_cast<std::size_t>(key.low);
+        }
+    };
+
+    // Most recently used entry first.
+    struct Shard final
+    {
+        mutable std::mutex mutex;
+        std::list<Entry> lru;
+        std::unordered_map<ContentHash, typename std::list<Entry>::iterator, KeyHash> index;
+    };
+
+    Func parser_;
+    ContentHash (*hash_)(const JsonValue &);
+    std::vector<Shard> shards_;
+    std::size_t shard_capacity_;
+    std::atomic<std::uint64_t> hits_{0};
+    std::atomic<std::uint64_t> misses_{0};
+    std::atomic<std::uint64_t> evictions_{0};
+};
+
+inline std::ostream &operator<<(std::ostream &stream, const CacheStats &stats)
+{
+    return stream << "CacheStats{hits=" << stats.hits << ", misses=" << stats.misses
+                  << ", evictions=" << stats.evictions << ", size=" << stats.size << "}";
+}
+
+} // namespace json
@@ -0,0 +1,573 @@
+#pragma once
+
+#include "json.hpp"
+#include "json_string.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <variant>
+#include <vector>
+
+namespace json
+{
+
+// JSON text usable as a template argument: `json::constant<R"({"a": 1})">`.
+template<std::size_t N>
+struct JsonText final
+{
+    consteval JsonText(const char (&text)[N])
+    {
+        std::copy_n(text, N, value);
+    }
+
+    constexpr std::string_view view() const noexcept
+    {
+        return {value, N - 1};
+    }
+
+    char value[N];
+};
+
+enum class ConstantKind : std::uint8_t
+{
+    object,
+    string,
+    number,
+    list,
+};
+
+// One value of a constant document. Nodes are stored in preorder: the members or elements of a
+// node follow it directly, and end skips its whole subtree. Object members carry their key.
+struct ConstantNode final
+{
+    JsonNumber number = 0;
+    std::uint64_t key_hash = 0;
+    std::uint32_t key_offset = 0;
+    std::uint32_t key_size = 0;
+    std::uint32_t string_offset = 0;
+    std::uint32_t string_size = 0;
+    std::uint32_t size = 0;
+    std::uint32_t end = 0;
+    ConstantKind kind = ConstantKind::number;
+};
+
+// Read-only view of a value in a constant document; cheap to copy, usable in constant evaluation.
+class ConstantValue final
+{
+public:
+    constexpr ConstantValue(const ConstantNode *nodes, const char *chars, std::uint32_t idx) noexcept
+        : nodes_(nodes)
+        , chars_(chars)
+        , idx_(idx)
+    {
+    }
+
+    constexpr ConstantKind kind() const noexcept
+    {
+        return node().kind;
+    }
+
+    // Number of members or elements, 0 for strings and numbers.
+    constexpr std::size_t size() const noexcept
+    {
+        return node().size;
+    }
+
+    constexpr std::optional<JsonNumber> number() const noexcept
+    {
+        return kind() == ConstantKind::number ? std::optional{node().number} : std::nullopt;
+    }
+
+    constexpr std::optional<std::string_view> string() const noexcept
+    {
+        return kind() == ConstantKind::string ? std::optional{view(node().string_offset, node().string_size)} : std::nullopt;
+    }
+
+    // The first member with this key, as with parse_field.
+    constexpr std::optional<ConstantValue> find(std::string_view key) const noexcept
+    {
+        if (kind() != ConstantKind::object)
+        {
+            return std::nullopt;
+        }
+        const std::uint64_t hash = detail::hash_key(key);
+        for (std::uint32_t child = idx_ + 1; child < node().end; child = nodes_[child].end)
+        {
+            if (nodes_[child].key_hash == hash && view(nodes_[child].key_offset, nodes_[child].key_size) == key)
+            {
+                return ConstantValue{nodes_, chars_, child};
+            }
+        }
+        return std::nullopt;
+    }
+
+    constexpr std::optional<ConstantValue> at(std::size_t idx) const noexcept
+    {
+        if (kind() != ConstantKind::list || idx >= size())
+        {
+            return std::nullopt;
+        }
+        std::uint32_t child = idx_ + 1;
+        for (; idx > 0; --idx)
+        {
+            child = nodes_[child].end;
+        }
+        return ConstantValue{nodes_, chars_, child};
+    }
+
+    // func(std::string_view key, ConstantValue value) for every member in document order.
+    template<typename Func>
+    constexpr void for_each_field(Func &&func) const
+    {
+        if (kind() == ConstantKind::object)
+        {
+            for (std::uint32_t child = idx_ + 1; child < node().end; child = nodes_[child].end)
+            {
+                func(view(nodes_[child].key_offset, nodes_[child].key_size), ConstantValue{nodes_, chars_, child});
+            }
+        }
+    }
+
+    template<typename Func>
+    constexpr void for_each_element(Func &&func) const
+    {
+        if (kind() == ConstantKind::list)
+        {
+            for (std::uint32_t child = idx_ + 1; child < node().end; child = nodes_[child].end)
+            {
+                func(ConstantValue{nodes_, chars_, child});
+            }
+        }
+    }
+
+    // Builds the equivalent JsonValue, e.g. to run the json.hpp combinators on it; constexpr, so
+    // this also works as a transient value during constant evaluation.
+    constexpr JsonValue to_json() const
+    {
+        switch (kind())
+        {
+        case ConstantKind::object:
+        {
+            JsonObject json_object;
+            json_object.reserve(size());
+            for_each_field([&json_object] (std::string_view key, ConstantValue value) {
+                json_object.emplace_back(JsonString(key), value.to_json());
+            });
+            return JsonValue{std::move(json_object)};
+        }
+        case ConstantKind::string:
+            return JsonValue{JsonString(*string())};
+        case ConstantKind::number:
+            return JsonValue{node().number};
+        case ConstantKind::list:
+        {
+            JsonList json_list;
+            json_list.reserve(size());
+            for_each_element([&json_list] (ConstantValue value) {
+                json_list.push_back(value.to_json());
+            });
+            return JsonValue{std::move(json_list)};
+        }
+        }
+        return JsonValue{};
+    }
+
+private:
+    constexpr const ConstantNode &node() const noexcept
+    {
+        return nodes_[idx_];
+    }
+
+    constexpr std::string_view view(std::uint32_t offset, std::uint32_t size) const noexcept
+    {
+        return {chars_ + offset, size};
+    }
+
+    const ConstantNode *nodes_;
+    const char *chars_;
+    std::uint32_t idx_;
+};
+
+// Parsed JSON text as flat arrays, a literal type: as a constexpr variable it lives in read-only data.
+template<std::size_t NodeCount, std::size_t CharCount>
+struct ConstantDocument final
+{
+    constexpr ConstantValue root() const noexcept
+    {
+        return ConstantValue{nodes.data(), chars.data(), 0};
+    }
+
+    std::array<ConstantNode, NodeCount> nodes{};
+    std::array<char, CharCount> chars{};
+};
+
+namespace detail
+{
+
+// Recursive descent over RFC 8259 JSON. Errors are exceptions, which fail the constant evaluation
+// and show up in the compiler diagnostic. true, false and null are rejected because JsonValue
+// cannot hold them.
+class ConstantParser final
+{
+public:
+    constexpr explicit ConstantParser(std::string_view text) noexcept
+        : text_(text)
+    {
+    }
+
+    constexpr void parse()
+    {
+        skip_whitespace();
+        parse_value(0, 0);
+        skip_whitespace();
+        if (position_ != text_.size())
+        {
+            throw std::invalid_argument("JSON constant: unexpected text after the value");
+        }
+    }
+
+    std::vector<ConstantNode> nodes;
+    std::string chars;
+
+private:
+    static constexpr std::size_t max_depth = 256;
+
+    constexpr void parse_value(std::size_t depth, std::uint64_t key_hash, std::uint32_t key_offset = 0, std::uint32_t key_size = 0)
+    {
+        if (depth > max_depth)
+        {
+            throw std::invalid_argument("JSON constant: nesting too deep");
+        }
+        const std::size_t idx = nodes.size();
+        nodes.push_back(ConstantNode{.key_hash = key_hash, .key_offset = key_offset, .key_size = key_size});
+        switch (peek())
+        {
+        case '{':
+            nodes[idx].kind = ConstantKind::object;
+            parse_members(idx, depth);
+            break;
+        case '[':
+            nodes[idx].kind = ConstantKind::list;
+            parse_elements(idx, depth);
+            break;
+        case '"':
+        {
+            const auto [offset, size] = parse_string();
+            nodes[idx].kind = ConstantKind::string;
+            nodes[idx].string_offset = offset;
+            nodes[idx].string_size = size;
+            break;
+        }
+        case 't':
+        case 'f':
+        case 'n':
+            throw std::invalid_argument("JSON constant: JsonValue has no true, false or null");
+        default:
+            nodes[idx].kind = ConstantKind::number;
+            nodes[idx].number = parse_number();
+            break;
+        }
+        nodes[idx].end = static_cast<std::uint32_t>(nodes.size());
+    }
+
+    constexpr void parse_members(std::size_t idx, std::size_t depth)
+    {
+        ++position_;
+        skip_whitespace();
+        if (consume('}'))
+        {
+            return;
+        }
+        do
+        {
+            skip_whitespace();
+            if (peek() != '"')
+            {
+                throw std::invalid_argument("JSON constant: expected object key");
+            }
+            const auto [offset, size] = parse_string();
+            skip_whitespace();
+            if (!consume(':'))
+            {
+                throw std::invalid_argument("JSON constant: expected ':'");
+            }
+            skip_whitespace();
+            parse_value(depth + 1, hash_key(std::string_view{chars}.substr(offset, size)), offset, size);
+            ++nodes[idx].size;
+            skip_whitespace();
+        } while (consume(','));
+        if (!consume('}'))
+        {
+            throw std::invalid_argument("JSON constant: expected ',' or '}'");
+        }
+    }
+
+    constexpr void parse_elements(std::size_t idx, std::size_t depth)
+    {
+        ++position_;
+        skip_whitespace();
+        if (consume(']'))
+        {
+            return;
+        }
+        do
+        {
+            skip_whitespace();
+            parse_value(depth + 1, 0);
+            ++nodes[idx].size;
+            skip_whitespace();
+        } while (consume(','));
+        if (!consume(']'))
+        {
+            throw std::invalid_argument("JSON constant: expected ',' or ']'");
+        }
+    }
+
+    // Decodes into chars and returns offset and size of the decoded string.
+    constexpr std::pair<std::uint32_t, std::uint32_t> parse_string()
+    {
+        ++position_;
+        const std::size_t offset = chars.size();
+        while (true)
+        {
+            if (position_ >= text_.size())
+            {
+                throw std::invalid_argument("JSON constant: unterminated string");
+            }
+            const char character = text_[position_];
+            if (character == '"')
+            {
+                ++position_;
+                break;
+            }
+            if (static_cast<unsigned char>(character) < 0x20)
+            {
+                throw std::invalid_argument("JSON constant: control character in string");
+            }
+            if (static_cast<unsigned char>(character) >= 0x80)
+            {
+                const std::size_t size = utf8_sequence_size(text_, position_);
+                if (size == 0)
+                {
+                    throw std::invalid_argument("JSON constant: invalid UTF-8 in string");
+                }
+                chars.append(text_.substr(position_, size));
+                position_ += size;
+            }
+            else if (character != '\\')
+            {
+                chars.push_back(character);
+                ++position_;
+            }
+            else
+            {
+                position_ = decode_escape(text_, position_, chars);
+                if (position_ == 0)
+                {
+                    throw std::invalid_argument("JSON constant: invalid escape");
+                }
+            }
+        }
+        return {static_cast<std::uint32_t>(offset), static_cast<std::uint32_t>(chars.size() - offset)};
+    }
+
+    // Exact (correctly rounded) when the significant digits fit in 2^53 and the decimal exponent
+    // is within +-22, which covers integers and short decimals; otherwise within a few ulp.
+    constexpr JsonNumber parse_number()
+    {
+        const bool negative = consume('-');
+        if (!is_digit(peek()))
+        {
+            throw std::invalid_argument("JSON constant: expected a value");
+        }
+        std::uint64_t mantissa = 0;
+        int exponent = 0;
+        std::size_t digits = 0;
+        const auto add_digit = [&] (char digit, bool fraction) {
+            if (digits < 19)
+            {
+                mantissa = mantissa * 10 + static_cast<std::uint64_t>(digit - '0');
+                digits += mantissa != 0 ? 1 : 0;
+                exponent -= fraction ? 1 : 0;
+            }
+            else
+            {
+                exponent += fraction ? 0 : 1;
+            }
+        };
+        if (consume('0'))
+        {
+            if (is_digit(peek()))
+            {
+                throw std::invalid_argument("JSON constant: leading zero");
+            }
+        }
+        else
+        {
+            while (is_digit(peek()))
+            {
+                add_digit(text_[position_++], false);
+            }
+        }
+        if (consume('.'))
+        {
+            if (!is_digit(peek()))
+            {
+                throw std::invalid_argument("JSON constant: expected digits after '.'");
+            }
+            while (is_digit(peek()))
+            {
+                add_digit(text_[position_++], true);
+            }
+        }
+        if (consume('e') || consume('E'))
+        {
+            const bool negative_exponent = consume('-');
+            if (!negative_exponent)
+            {
+                consume('+');
+            }
+            if (!is_digit(peek()))
+            {
+                throw std::invalid_argument("JSON constant: expected exponent digits");
+            }
+            int written = 0;
+            while (is_digit(peek()))
+            {
+                written = std::min(written * 10 + (text_[position_++] - '0'), 100000);
+            }
+            exponent += negative_exponent ? -written : written;
+        }
+        JsonNumber value = static_cast<JsonNumber>(mantissa);
+        if (mantissa != 0)
+        {
+            constexpr JsonNumber exact_powers[] = {
+                1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+                1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22,
+            };
+            for (; exponent > 22; exponent -= 22)
+            {
+                value = scale_up(value, 1e22);
+            }
+            for (; exponent < -22; exponent += 22)
+            {
+                value /= 1e22;
+            }
+            value = exponent >= 0 ? scale_up(value, exact_powers[exponent]) : value / exact_powers[-exponent];
+        }
+        return negative ? -value : value;
+    }
+
+    static constexpr JsonNumber scale_up(JsonNumber value, JsonNumber factor)
+    {
+        if (value > std::numeric_limits<JsonNumber>::max() / factor)
+        {
+            throw std::invalid_argument("JSON constant: number out of range");
+        }
+        return value * factor;
+    }
+
+    static constexpr bool is_digit(char character) noexcept
+    {
+        return character >= '0' && character <= '9';
+    }
+
+    constexpr char peek() const noexcept
+    {
+        return position_ < text_.size() ? text_[position_] : '\0';
+    }
+
+    constexpr bool consume(char character) noexcept
+    {
+        if (peek() == character)
+        {
+            ++position_;
+            return true;
+        }
+        return false;
+    }
+
+    constexpr void skip_whitespace() noexcept
+    {
+        while (peek() == ' ' || peek() == '\t' || peek() == '\n' || peek() == '\r')
+        {
+            ++position_;
+        }
+    }
+
+    std::string_view text_;
+    std::size_t position_ = 0;
+};
+
+struct ConstantSize final
+{
+    std::size_t nodes;
+    std::size_t chars;
+};
+
+consteval ConstantSize measure_constant(std::string_view text)
+{
+    ConstantParser parser{text};
+    parser.parse();
+    return {parser.nodes.size(), parser.chars.size()};
+}
+
+// The text is parsed twice: once to size the arrays, once to fill them.
+template<JsonText Text>
+consteval auto make_constant()
+{
+    constexpr ConstantSize size = measure_constant(Text.view());
+    ConstantParser parser{Text.view()};
+    parser.parse();
+    ConstantDocument<size.nodes, size.chars> document;
+    std::copy(parser.nodes.begin(), parser.nodes.end(), document.nodes.begin());
+    std::copy(parser.chars.begin(), parser.chars.end(), document.chars.begin());
+    return document;
+}
+
+template<typename T>
+consteval T parsed_constant(Parser<T> &&result)
+{
+    if (!std::holds_alternative<T>(result.value))
+    {
+        throw std::invalid_argument("parse_constant: the constant does not parse");
+    }
+    return std::get<T>(std::move(result.value));
+}
+
+} // namespace detail
+
+// `json::constant<R"({"a": 1, "b": 2.5})">.root()` is parsed and validated at compile time.
+template<JsonText Text>
+inline constexpr auto constant = detail::make_constant<Text>();
+
+// Runs a JsonValue parser on a constant during constant evaluation and returns its value, so that
+// defaults are baked in: `constexpr Config defaults = json::parse_constant(json::constant<...>.root(), parser);`.
+// A parse error fails compilation.
+template<typename Func>
+consteval auto parse_constant(ConstantValue value, const Func &parser)
+{
+    return detail::parsed_constant(parser(value.to_json()));
+}
+
+namespace literals
+{
+
+// `using namespace json::literals; constexpr auto defaults = R"({"a": 1})"_json;`
+template<JsonText Text>
+consteval auto operator""_json()
+{
+    return constant<Text>;
+}
+
+} // namespace literals
+
+} // namespace json
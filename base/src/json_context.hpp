@@ -0,0 +1,246 @@
+#pragma once
+
+#include "json.hpp"
+#include "json_string.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <ranges>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <variant>
+#include <vector>
+
+namespace json
+{
+
+namespace detail
+{
+
+template<typename T>
+struct is_std_vector final : std::false_type {};
+
+template<typename T>
+struct is_std_vector<std::vector<T>> final : std::true_type {};
+
+// Chunked storage for decoded strings. Chunks never move, so views stay valid until reset(), and
+// reset() keeps them, so the next document is stored without allocating.
+class StringArena final
+{
+public:
+    std::string_view store(std::string_view text)
+    {
+        if (text.empty())
+        {
+            return {};
+        }
+        while (current_ < chunks_.size() && chunks_[current_].size - used_ < text.size())
+        {
+            ++current_;
+            used_ = 0;
+        }
+        if (current_ == chunks_.size())
+        {
+            const std::size_t size = std::max(chunk_size, text.size());
+            chunks_.push_back(Chunk{std::make_unique<char[]>(size), size});
+        }
+        char *destination = chunks_[current_].data.get() + used_;
+        std::memcpy(destination, text.data(), text.size());
+        used_ += text.size();
+        return {destination, text.size()};
+    }
+
+    void reset() noexcept
+    {
+        current_ = 0;
+        used_ = 0;
+    }
+
+private:
+    static constexpr std::size_t chunk_size = 4096;
+
+    struct Chunk final
+    {
+        std::unique_ptr<char[]> data;
+        std::size_t size;
+    };
+
+    std::vector<Chunk> chunks_;
+    std::size_t current_ = 0;
+    std::size_t used_ = 0;
+};
+
+} // namespace detail
+
+// Storage reused from one document to the next: free lists of the vectors and strings of earlier
+// documents, an arena for decoded strings, and the buffers error messages are built in.
+//
+//     json::ParseContext context;
+//     for (...)
+//     {
+//         json::JsonValue document = build(context);          // acquire_object/list/string
+//         auto result = context.parse(parser, document);      // errors and lists from the pools
+//         use(result);
+//         context.recycle(std::move(result));
+//         context.recycle(std::move(document));
+//         context.reset_arena();
+//     }
+//
+// Once the pools have seen a document of each shape, such a loop does not allocate. A context
+// belongs to one thread at a time; parse() makes it the recycler of the calling thread for the
+// duration of the call, which is how the combinators reach it without an extra argument.
+class ParseContext final
+{
+public:
+    ParseContext() = default;
+    ParseContext(const ParseContext &) = delete;
+    ParseContext &operator=(const ParseContext &) = delete;
+
+    // An empty object/list with the capacity of one recycled earlier. recycle() returns a document
+    // so that building the next one in the same order gets back the same capacities.
+    JsonObject acquire_object()
+    {
+        return recycler_.acquire_vector<JsonObject::value_type>();
+    }
+
+    JsonList acquire_list()
+    {
+        return recycler_.acquire_vector<JsonValue>();
+    }
+
+    // Short strings fit the small-string buffer, so they leave the pooled buffers to longer ones.
+    JsonString acquire_string(std::string_view text)
+    {
+        if (text.size() <= JsonString{}.capacity())
+        {
+            return JsonString{text};
+        }
+        JsonString string = recycler_.acquire_string();
+        string.assign(text);
+        return string;
+    }
+
+    // Hands the vectors and strings of json_value back to the free lists.
+    void recycle(JsonValue &&json_value)
+    {
+        visit(overloaded([this] (JsonObject &json_object) {
+                             for (auto &field : std::views::reverse(json_object))
+                             {
+                                 recycle(std::move(field.second));
+                                 recycler_.release_string(std::move(field.first));
+                             }
+                             recycler_.release_vector(std::move(json_object));
+                         },
+                         [this] (JsonList &json_list) {
+                             for (auto &element : std::views::reverse(json_list))
+                             {
+                                 recycle(std::move(element));
+                             }
+                             recycler_.release_vector(std::move(json_list));
+                         },
+                         [this] (JsonString &json_string) {
+                             recycler_.release_string(std::move(json_string));
+                         },
+                         [] (JsonNumber) {
+                         }),
+              json_value.value);
+    }
+
+    // Hands the error strings of result back, and its value when that is a list, e.g. the result
+    // of functional::traverse.
+    template<typename T>
+    void recycle(Parser<T> &&result)
+    {
+        if (auto *parse_error = std::get_if<ParseError>(&result.value))
+        {
+            recycler_.release_string(std::move(parse_error->error_message));
+        }
+        if constexpr (detail::is_std_vector<T>::value)
+        {
+            if (auto *values = std::get_if<T>(&result.value))
+            {
+                recycler_.release_vector(std::move(*values));
+            }
+        }
+        else if constexpr (std::is_same_v<T, JsonValue>)
+        {
+            if (auto *value = std::get_if<JsonValue>(&result.value))
+            {
+                recycle(std::move(*value));
+            }
+        }
+        recycler_.release_string(std::move(result.error_prefix));
+        recycler_.release_string(std::move(result.error_suffix));
+    }
+
+    // Runs parser on json_value with this context as the recycler. A parser built with
+    // with_object_in is run with std::ref(*this) as its environment, so nested parsers can store
+    // and decode strings in the arena.
+    template<typename ParserFunc>
+    auto parse(const ParserFunc &parser, const JsonValue &json_value)
+    {
+        const Activation activation{recycler_};
+        auto result = parser(json_value);
+        if constexpr (functional::is_instance_v<functional::Reader, decltype(result)>)
+        {
+            return std::move(result).run(std::ref(*this));
+        }
+        else
+        {
+            return result;
+        }
+    }
+
+    // Copies text into the arena; the view is valid until reset_arena().
+    std::string_view store(std::string_view text)
+    {
+        return arena_.store(text);
+    }
+
+    // json::decode_string with the decoded text kept in the arena: unescaped input is borrowed
+    // from raw, decoded input lives until reset_arena().
+    Parser<std::string_view> decode_string(std::string_view raw)
+    {
+        auto decoded = json::decode_string(raw, scratch_);
+        if (auto *text = std::get_if<std::string_view>(&decoded.value); text && text->data() == scratch_.data())
+        {
+            *text = arena_.store(*text);
+        }
+        return decoded;
+    }
+
+    void reset_arena() noexcept
+    {
+        arena_.reset();
+    }
+
+private:
+    class Activation final
+    {
+    public:
+        explicit Activation(detail::Recycler &recycler) noexcept
+            : previous_(std::exchange(detail::active_recycler, &recycler))
+        {
+        }
+        Activation(const Activation &) = delete;
+        Activation &operator=(const Activation &) = delete;
+        ~Activation()
+        {
+            detail::active_recycler = previous_;
+        }
+
+    private:
+        detail::Recycler *previous_;
+    };
+
+    detail::Recycler recycler_;
+    detail::StringArena arena_;
+    std::string scratch_;
+};
+
+} // namespace json
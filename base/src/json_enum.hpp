@@ -0,0 +1,133 @@
+#pragma once
+
+#include "json.hpp"
+
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <variant>
+
+namespace json
+{
+
+namespace detail
+{
+
+constexpr std::uint64_t seeded_hash_key(std::string_view key, std::uint64_t seed) noexcept
+{
+    std::uint64_t hash = 0xcbf2'9ce4'8422'2325 ^ (seed * 0x9e37'79b9'7f4a'7c15);
+    for (const char character : key)
+    {
+        hash = (hash ^ static_cast<unsigned char>(character)) * 0x0000'0100'0000'01b3;
+    }
+    return hash ^ (hash >> 29);
+}
+
+} // namespace detail
+
+// Maps a fixed set of JSON strings to values of E, typically an enum. The table is a perfect hash
+// found at compile time: a lookup is one hash, one table load and one string comparison, and a
+// hit does not allocate.
+template<typename E, std::size_t N>
+class EnumParser final
+{
+    static_assert(N > 0, "enum_parser needs at least one entry");
+    static_assert(N < 0xffff, "enum_parser supports up to 65534 entries");
+
+public:
+    static constexpr std::size_t table_capacity = std::bit_ceil(N) * 8;
+
+    consteval EnumParser(std::string_view class_name, const std::pair<std::string_view, E> (&entries)[N])
+        : class_name_(class_name)
+    {
+        for (std::size_t idx = 0; idx < N; ++idx)
+        {
+            for (std::size_t other = 0; other < idx; ++other)
+            {
+                if (entries[idx].first == entries[other].first)
+                {
+                    throw std::invalid_argument("enum_parser entries must have distinct names");
+                }
+            }
+            entries_[idx] = entries[idx];
+        }
+        for (std::size_t table_size = std::bit_ceil(N); table_size <= table_capacity; table_size *= 2)
+        {
+            for (std::uint64_t seed = 0; seed < 4096; ++seed)
+            {
+                if (try_build(table_size - 1, seed))
+                {
+                    return;
+                }
+            }
+        }
+        throw std::logic_error("no perfect hash found for the enum_parser entries");
+    }
+
+    constexpr std::optional<E> find(std::string_view name) const noexcept
+    {
+        const std::uint16_t slot = table_[detail::seeded_hash_key(name, seed_) & mask_];
+        if (slot && entries_[slot - 1].first == name)
+        {
+            return entries_[slot - 1].second;
+        }
+        return std::nullopt;
+    }
+
+    // Errors are worded like with_string's and name the unknown string. They are only built on a
+    // miss, in a buffer from the active ParseContext when there is one.
+    Parser<E> operator()(const JsonValue &json_value) const
+    {
+        const auto *json_string = std::get_if<JsonString>(&json_value.value);
+        if (!json_string)
+        {
+            return Parser<E>{ParseError{detail::error_string("Expected JSON string for ", class_name_)}};
+        }
+        if (const std::optional<E> value = find(*json_string))
+        {
+            return Parser<E>{*value};
+        }
+        return Parser<E>{ParseError{detail::error_string("Unknown JSON string \"", *json_string, "\" for ", class_name_)}};
+    }
+
+private:
+    consteval bool try_build(std::size_t mask, std::uint64_t seed)
+    {
+        table_ = {};
+        for (std::size_t idx = 0; idx < N; ++idx)
+        {
+            std::uint16_t &slot = table_[detail::seeded_hash_key(entries_[idx].first, seed) & mask];
+            if (slot)
+            {
+                return false;
+            }
+            slot = static_cast<std::uint16_t>(idx + 1);
+        }
+        mask_ = mask;
+        seed_ = seed;
+        return true;
+    }
+
+    std::string_view class_name_;
+    std::array<std::pair<std::string_view, E>, N> entries_{};
+    // Entry index + 1 per bucket, 0 for an empty bucket.
+    std::array<std::uint16_t, table_capacity> table_{};
+    std::size_t mask_ = 0;
+    std::uint64_t seed_ = 0;
+};
+
+// `constexpr auto parse_color = json::enum_parser<Color>("Color"sv, {{"red", Color::red}, {"green", Color::green}});`
+// The result is a parser of JSON values, and find() serves strings that are already extracted.
+template<typename E, std::size_t N>
+consteval EnumParser<E, N> enum_parser(std::string_view class_name, const std::pair<std::string_view, E> (&entries)[N])
+{
+    return EnumParser<E, N>{class_name, entries};
+}
+
+} // namespace json
@@ -0,0 +1,301 @@
+#pragma once
+
+#include "json.hpp"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <variant>
+
+namespace json
+{
+
+// String literal usable as a template argument: `field<"name", &T::name>`.
+template<std::size_t N>
+struct FieldName final
+{
+    consteval FieldName(const char (&name)[N])
+    {
+        std::copy_n(name, N, value);
+    }
+
+    constexpr std::string_view view() const noexcept
+    {
+        return {value, N - 1};
+    }
+
+    char value[N];
+};
+
+namespace detail
+{
+
+template<typename MemberPointer>
+struct MemberPointerTraits;
+
+template<typename Class, typename Member>
+struct MemberPointerTraits<Member Class::*> final
+{
+    using class_type = Class;
+    using member_type = Member;
+};
+
+// Decodes the JSON types directly; arithmetic members are converted from JsonNumber. Integral
+// members only take integral numbers in their range, as SchemaType::integer does; floating members
+// only take numbers they can represent in magnitude.
+struct BuiltinDecoder final
+{
+};
+
+template<typename Member>
+constexpr std::string_view builtin_type_name()
+{
+    if constexpr (std::is_arithmetic_v<Member>)
+    {
+        return "number for JsonNumber";
+    }
+    else if constexpr (std::is_same_v<Member, JsonString>)
+    {
+        return "string for JsonString";
+    }
+    else if constexpr (std::is_same_v<Member, JsonList>)
+    {
+        return "list for JsonList";
+    }
+    else
+    {
+        static_assert(std::is_same_v<Member, JsonObject>, "no builtin JSON decoder for this member type, pass one to json::field");
+        return "object for JsonObject";
+    }
+}
+
+template<typename Member>
+constexpr bool decode_builtin(const JsonValue &json_value, Member &member)
+{
+    if constexpr (std::is_same_v<Member, JsonValue>)
+    {
+        member = json_value;
+        return true;
+    }
+    else
+    {
+        using JsonType = std::conditional_t<std::is_arithmetic_v<Member>, JsonNumber, Member>;
+        const auto *found = std::get_if<JsonType>(&json_value.value);
+        if (!found)
+        {
+            return false;
+        }
+        if constexpr (std::is_integral_v<Member>)
+        {
+            // The range check comes first, so the cast back is defined; NaN fails it.
+            const JsonNumber number = *found;
+            if (!(number >= static_cast<JsonNumber>(std::numeric_limits<Member>::min())
+                  && number < static_cast<JsonNumber>(std::numeric_limits<Member>::max()) + 1.0)
+                || static_cast<JsonNumber>(static_cast<Member>(number)) != number)
+            {
+                return false;
+            }
+        }
+        else if constexpr (std::is_floating_point_v<Member> && sizeof(Member) < sizeof(JsonNumber))
+        {
+            if (*found > std::numeric_limits<Member>::max() || *found < std::numeric_limits<Member>::lowest())
+            {
+                return false;
+            }
+        }
+        member = static_cast<Member>(*found);
+        return true;
+    }
+}
+
+} // namespace detail
+
+// One member of a derived parser. Decoder is detail::BuiltinDecoder or a function
+// `Parser<Member> (*)(const JsonValue &)`, e.g. another with_fields parser wrapped in a function.
+template<FieldName Name, auto Member, auto Decoder = detail::BuiltinDecoder{}>
+    requires std::is_member_object_pointer_v<decltype(Member)>
+struct field final
+{
+    using class_type = typename detail::MemberPointerTraits<decltype(Member)>::class_type;
+    using member_type = typename detail::MemberPointerTraits<decltype(Member)>::member_type;
+
+    static constexpr std::string_view name = Name.view();
+    static constexpr auto member = Member;
+    static constexpr auto decoder = Decoder;
+};
+
+// Field table of an aggregate: `json::fields<json::field<"a", &T::a>, json::field<"b", &T::b>>`.
+template<typename First, typename ...Rest>
+    requires (std::is_same_v<typename First::class_type, typename Rest::class_type> && ...)
+struct fields final
+{
+    using type = typename First::class_type;
+    static constexpr std::size_t size = 1 + sizeof...(Rest);
+    static constexpr std::array<std::string_view, size> names{First::name, Rest::name...};
+
+    static_assert(std::is_default_constructible_v<type>, "derived parsers decode into a value-initialized object");
+    static_assert(size <= 64, "derived parsers track up to 64 fields");
+};
+
+namespace detail
+{
+
+template<typename Class>
+constexpr Parser<Class> field_error(std::string_view class_name, std::string error_message)
+{
+    using namespace std::literals;
+    return Parser<Class>{ParseError{std::move(error_message)}, "When parsing JSON object for "s + std::string(class_name) + ": ", {}};
+}
+
+template<typename Class>
+constexpr Parser<Class> field_error(std::string_view class_name, std::string_view prefix, std::string_view message, std::string_view suffix)
+{
+    return field_error<Class>(class_name, error_string(prefix, message, suffix));
+}
+
+// On failure stores the parser to return in failure, worded like the error of an applicative
+// with_object/parse_field schema.
+template<typename Field>
+constexpr bool decode_field(const JsonValue &json_value, typename Field::class_type &object,
+                            std::string_view class_name, Parser<typename Field::class_type> &failure)
+{
+    using Class = typename Field::class_type;
+    using Member = typename Field::member_type;
+    auto &member = object.*Field::member;
+    using namespace std::literals;
+    if constexpr (std::is_same_v<std::remove_cvref_t<decltype(Field::decoder)>, BuiltinDecoder>)
+    {
+        if (decode_builtin(json_value, member))
+        {
+            return true;
+        }
+        // A number that does not fit the member is reported as such; other mismatches as with parse_field.
+        std::string_view expected = builtin_type_name<Member>();
+        if (std::is_arithmetic_v<Member> && std::holds_alternative<JsonNumber>(json_value.value))
+        {
+            expected = std::is_integral_v<Member> ? "integral number in range of the member" : "number in range of the member";
+        }
+        failure = field_error<Class>(class_name, "When parsing JSON object field \""s + std::string(Field::name) + "\": ",
+                                     "Expected JSON "s + std::string(expected), {});
+        return false;
+    }
+    else
+    {
+        auto decoded = Field::decoder(json_value);
+        if (auto *value = std::get_if<Member>(&decoded.value))
+        {
+            member = std::move(*value);
+            return true;
+        }
+        if (auto *parse_error = std::get_if<ParseError>(&decoded.value))
+        {
+            failure = field_error<Class>(class_name, "When parsing JSON object field \""s + std::string(Field::name) + "\": " + decoded.error_prefix,
+                                         parse_error->error_message, decoded.error_suffix);
+        }
+        else
+        {
+            failure = Parser<Class>{};
+        }
+        return false;
+    }
+}
+
+// Looks the key up starting at hint: objects usually list their keys in declaration order, so
+// a well-ordered object costs one comparison per key.
+template<typename Fields>
+constexpr std::size_t find_field(std::string_view key, std::size_t hint)
+{
+    for (std::size_t offset = 0; offset < Fields::size; ++offset)
+    {
+        const std::size_t idx = (hint + offset) % Fields::size;
+        if (Fields::names[idx] == key)
+        {
+            return idx;
+        }
+    }
+    return Fields::size;
+}
+
+template<typename ...Field>
+constexpr Parser<typename fields<Field...>::type> parse_fields(std::string_view class_name, const JsonValue &json_value, fields<Field...>)
+{
+    using Fields = fields<Field...>;
+    using Result = Parser<typename Fields::type>;
+    using namespace std::literals;
+    const auto *json_object = std::get_if<JsonObject>(&json_value.value);
+    if (!json_object)
+    {
+        return Result{ParseError{"Expected JSON object for " + std::string(class_name)}};
+    }
+
+    // Members are decoded straight into the object held by the result.
+    Result result{typename Fields::type{}};
+    auto &object = std::get<typename Fields::type>(result.value);
+    std::uint64_t seen = 0;
+    std::size_t hint = 0;
+    Result failure;
+    for (const auto &[key, value] : *json_object)
+    {
+        const std::size_t idx = find_field<Fields>(key, hint);
+        // Unknown keys are ignored and the first occurrence of a key wins, as with parse_field.
+        if (idx == Fields::size || (seen & (std::uint64_t{1} << idx)))
+        {
+            continue;
+        }
+        seen |= std::uint64_t{1} << idx;
+        hint = idx + 1;
+        const bool decoded = [&] <std::size_t ...Idx> (std::index_sequence<Idx...>) {
+            return ((Idx == idx && decode_field<Field>(value, object, class_name, failure)) || ...);
+        }(std::index_sequence_for<Field...>{});
+        if (!decoded)
+        {
+            return failure;
+        }
+    }
+
+    if (const std::uint64_t all = ~std::uint64_t{0} >> (64 - Fields::size); seen != all)
+    {
+        const std::size_t missing = std::countr_one(seen);
+        return field_error<typename Fields::type>(class_name, {}, "Expected JSON object field \""s + std::string(Fields::names[missing]) + "\"", {});
+    }
+    return result;
+}
+
+} // namespace detail
+
+// Derived parser for an aggregate described by a fields<...> table. Produces the same values and
+// error messages as the equivalent with_object/partially_applicable/parse_field schema, but
+// decodes in a single pass over the object, without per-field Parser temporaries or closures.
+// Where the errors differ from the hand-written schema:
+// - parse_fields reports the first bad key in object order, then the first missing field; the
+//   fmap/fapply chain reports the first bad field in declaration order;
+// - the chain pads the message with a space on each side per combinator it passes through,
+//   parse_fields emits "prefix message" as is;
+// - numbers that do not fit a member are errors rather than a static_cast.
+// The policy comes first as with the other combinators: `with_fields<json::Instrumented, MyStructFields>(...)`.
+template<typename Instrumentation, typename Fields>
+    requires std::is_same_v<decltype(Instrumentation::enabled), const bool>
+consteval auto with_fields(std::string_view class_name_sv)
+{
+    return [class_name = class_name_sv] (const JsonValue &json_value) {
+        return detail::instrumented<Instrumentation>("with_fields", class_name, [&] {
+            return detail::parse_fields(class_name, json_value, Fields{});
+        });
+    };
+}
+
+template<typename Fields>
+consteval auto with_fields(std::string_view class_name_sv)
+{
+    return with_fields<NoInstrumentation, Fields>(class_name_sv);
+}
+
+} // namespace json
@@ -0,0 +1,194 @@
+#pragma once
+
+#include "json.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace json
+{
+
+// Bucket i counts calls that took [2^(i-1), 2^i) nanoseconds; bucket 0 counts calls under 1 ns.
+inline constexpr std::size_t latency_buckets = 48;
+
+struct CombinatorSnapshot final
+{
+    std::string kind;
+    std::string name;
+    std::uint64_t calls = 0;
+    std::uint64_t failures = 0;
+    std::uint64_t total_ns = 0;
+    std::array<std::uint64_t, latency_buckets> latency_histogram{};
+};
+
+// Process-wide statistics of instrumented combinators, keyed by combinator kind and the
+// class_name/field_name given to it. Counters are atomics, so recording only takes a shared lock.
+class InstrumentationRegistry final
+{
+public:
+    static InstrumentationRegistry &global()
+    {
+        static InstrumentationRegistry registry;
+        return registry;
+    }
+
+    void record(std::string_view kind, std::string_view name, bool failed, std::chrono::nanoseconds latency)
+    {
+        Stats &stats = find_or_create(kind, name);
+        const auto latency_ns = static_cast<std::uint64_t>(std::max<std::chrono::nanoseconds::rep>(latency.count(), 0));
+        stats.calls.fetch_add(1, std::memory_order_relaxed);
+        stats.failures.fetch_add(failed ? 1 : 0, std::memory_order_relaxed);
+        stats.total_ns.fetch_add(latency_ns, std::memory_order_relaxed);
+        const std::size_t bucket = std::min<std::size_t>(std::bit_width(latency_ns), latency_buckets - 1);
+        stats.latency_histogram[bucket].fetch_add(1, std::memory_order_relaxed);
+    }
+
+    std::vector<CombinatorSnapshot> snapshot() const
+    {
+        std::shared_lock lock{mutex_};
+        std::vector<CombinatorSnapshot> result;
+        result.reserve(stats_.size());
+        for (const auto &[key, stats] : stats_)
+        {
+            CombinatorSnapshot &entry = result.emplace_back();
+            entry.kind = key.kind;
+            entry.name = key.name;
+            entry.calls = stats->calls.load(std::memory_order_relaxed);
+            entry.failures = stats->failures.load(std::memory_order_relaxed);
+            entry.total_ns = stats->total_ns.load(std::memory_order_relaxed);
+            for (std::size_t idx = 0; idx < latency_buckets; ++idx)
+            {
+                entry.latency_histogram[idx] = stats->latency_histogram[idx].load(std::memory_order_relaxed);
+            }
+        }
+        return result;
+    }
+
+    // Zeroes the counters; entries stay alive because recorders may still hold them.
+    void reset()
+    {
+        std::shared_lock lock{mutex_};
+        for (const auto &entry : stats_)
+        {
+            Stats &stats = *entry.second;
+            stats.calls.store(0, std::memory_order_relaxed);
+            stats.failures.store(0, std::memory_order_relaxed);
+            stats.total_ns.store(0, std::memory_order_relaxed);
+            for (auto &bucket : stats.latency_histogram)
+            {
+                bucket.store(0, std::memory_order_relaxed);
+            }
+        }
+    }
+
+private:
+    struct Stats final
+    {
+        std::atomic<std::uint64_t> calls{0};
+        std::atomic<std::uint64_t> failures{0};
+        std::atomic<std::uint64_t> total_ns{0};
+        std::array<std::atomic<std::uint64_t>, latency_buckets> latency_histogram{};
+    };
+
+    struct Key final
+    {
+        std::string kind;
+        std::string name;
+    };
+
+    struct KeyView final
+    {
+        std::string_view kind;
+        std::string_view name;
+    };
+
+    struct KeyLess final
+    {
+        using is_transparent = void;
+
+        template<typename Lhs, typename Rhs>
+        bool operator()(const Lhs &lhs, const Rhs &rhs) const noexcept
+        {
+            const int kind_order = std::string_view{lhs.kind}.compare(rhs.kind);
+            return kind_order < 0 || (kind_order == 0 && std::string_view{lhs.name} < std::string_view{rhs.name});
+        }
+    };
+
+    Stats &find_or_create(std::string_view kind, std::string_view name)
+    {
+        const KeyView key{kind, name};
+        {
+            std::shared_lock lock{mutex_};
+            if (const auto found = stats_.find(key); found != stats_.end())
+            {
+                return *found->second;
+            }
+        }
+        std::unique_lock lock{mutex_};
+        auto [position, inserted] = stats_.try_emplace(Key{std::string(kind), std::string(name)});
+        if (inserted)
+        {
+            position->second = std::make_unique<Stats>();
+        }
+        return *position->second;
+    }
+
+    mutable std::shared_mutex mutex_;
+    std::map<Key, std::unique_ptr<Stats>, KeyLess> stats_;
+};
+
+// Recording policy: `with_object<json::Instrumented>(...)`, `parse_field<json::Instrumented, JsonNumber>(...)`.
+struct Instrumented final
+{
+    static constexpr bool enabled = true;
+
+    static void record(std::string_view kind, std::string_view name, bool failed, std::chrono::nanoseconds latency) noexcept
+    {
+        try
+        {
+            InstrumentationRegistry::global().record(kind, name, failed, latency);
+        }
+        catch (...)
+        {
+            // Losing a sample is preferable to failing the parse.
+        }
+    }
+};
+
+inline std::vector<CombinatorSnapshot> instrumentation_snapshot()
+{
+    return InstrumentationRegistry::global().snapshot();
+}
+
+inline std::ostream &operator<<(std::ostream &stream, const CombinatorSnapshot &snapshot)
+{
+    stream << snapshot.kind << " \"" << snapshot.name << "\": calls=" << snapshot.calls
+           << " failures=" << snapshot.failures
+           << " mean_ns=" << (snapshot.calls ? snapshot.total_ns / snapshot.calls : 0)
+           << " histogram_ns={";
+    bool first = true;
+    for (std::size_t idx = 0; idx < latency_buckets; ++idx)
+    {
+        if (snapshot.latency_histogram[idx])
+        {
+            stream << (first ? "" : ", ") << "<" << (std::uint64_t{1} << idx) << ": " << snapshot.latency_histogram[idx];
+            first = false;
+        }
+    }
+    return stream << "}";
+}
+
+} // namespace json
@@ -0,0 +1,495 @@
+#pragma once
+
+#include "json.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <initializer_list>
+#include <limits>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <variant>
+#include <vector>
+
+namespace json
+{
+
+// JSON Pointers (RFC 6901), e.g. "/payload/items/3/price", evaluated by reference: no level of the
+// document is copied on the way down. A token that is an array index also matches an object key
+// of the same spelling, as the RFC requires.
+
+// JSON Pointer usable as a template argument: `json::path<"/payload/items/3/price">`.
+template<std::size_t N>
+struct PathText final
+{
+    consteval PathText(const char (&text)[N])
+    {
+        std::copy_n(text, N, value);
+    }
+
+    constexpr std::string_view view() const noexcept
+    {
+        return {value, N - 1};
+    }
+
+    char value[N];
+};
+
+// One reference token, unescaped; the key bytes live in the owning path's key pool.
+struct PathSegment final
+{
+    static constexpr std::size_t no_index = std::numeric_limits<std::size_t>::max();
+
+    std::uint64_t key_hash = 0;
+    std::uint32_t key_offset = 0;
+    std::uint32_t key_size = 0;
+    std::size_t index = no_index;
+};
+
+namespace detail
+{
+
+// Splits and unescapes a pointer, calling token(std::string_view) per reference token; the views
+// are only valid during the call.
+template<typename Func>
+constexpr void for_each_pointer_token(std::string_view pointer, Func &&token)
+{
+    if (!pointer.empty() && pointer.front() != '/')
+    {
+        throw std::invalid_argument("JSON pointer must be empty or start with '/'");
+    }
+    std::string unescaped;
+    for (std::size_t position = 0; position < pointer.size();)
+    {
+        const std::size_t end = std::min(pointer.find('/', position + 1), pointer.size());
+        unescaped.clear();
+        for (std::size_t idx = position + 1; idx < end; ++idx)
+        {
+            if (pointer[idx] != '~')
+            {
+                unescaped.push_back(pointer[idx]);
+            }
+            else if (idx + 1 < end && (pointer[idx + 1] == '0' || pointer[idx + 1] == '1'))
+            {
+                unescaped.push_back(pointer[++idx] == '0' ? '~' : '/');
+            }
+            else
+            {
+                throw std::invalid_argument("JSON pointer has '~' not followed by '0' or '1'");
+            }
+        }
+        token(std::string_view{unescaped});
+        position = end;
+    }
+}
+
+// "0" or digits without a leading zero; "-" (past the end) and anything else is no index.
+constexpr std::size_t pointer_index(std::string_view token) noexcept
+{
+    if (token.empty() || token.size() > 18 || (token.size() > 1 && token.front() == '0'))
+    {
+        return PathSegment::no_index;
+    }
+    std::size_t index = 0;
+    for (const char character : token)
+    {
+        if (character < '0' || character > '9')
+        {
+            return PathSegment::no_index;
+        }
+        index = index * 10 + static_cast<std::size_t>(character - '0');
+    }
+    return index;
+}
+
+enum class PathFailure : std::uint8_t
+{
+    none,
+    missing_field,
+    missing_element,
+    not_container,
+};
+
+// Follows segments from json_value; on failure returns nullptr and reports which segment failed.
+constexpr const JsonValue *walk_path(const JsonValue &json_value, std::span<const PathSegment> segments, const char *keys,
+                                     std::size_t &failed_segment, PathFailure &failure) noexcept
+{
+    const JsonValue *current = &json_value;
+    for (std::size_t idx = 0; idx < segments.size(); ++idx)
+    {
+        const PathSegment &segment = segments[idx];
+        if (const auto *json_object = std::get_if<JsonObject>(&current->value))
+        {
+            const std::string_view key{keys + segment.key_offset, segment.key_size};
+            const auto found = std::find_if(json_object->begin(), json_object->end(), [key] (const auto &field) {
+                return field.first.size() == key.size() && std::string_view{field.first} == key;
+            });
+            if (found == json_object->end())
+            {
+                failed_segment = idx;
+                failure = PathFailure::missing_field;
+                return nullptr;
+            }
+            current = &found->second;
+        }
+        else if (const auto *json_list = std::get_if<JsonList>(&current->value))
+        {
+            if (segment.index >= json_list->size())
+            {
+                failed_segment = idx;
+                failure = PathFailure::missing_element;
+                return nullptr;
+            }
+            current = &(*json_list)[segment.index];
+        }
+        else
+        {
+            failed_segment = idx;
+            failure = PathFailure::not_container;
+            return nullptr;
+        }
+    }
+    return current;
+}
+
+template<typename Result>
+Result path_error(std::string_view pointer, std::span<const PathSegment> segments, const char *keys,
+                  std::size_t failed_segment, PathFailure failure)
+{
+    using namespace std::literals;
+    const PathSegment &segment = segments[failed_segment];
+    const std::string token{keys + segment.key_offset, segment.key_size};
+    std::string error_message;
+    switch (failure)
+    {
+    case PathFailure::missing_field:
+        error_message = "Expected JSON object field \""s + token + "\"";
+        break;
+    case PathFailure::missing_element:
+        error_message = "Expected JSON list element " + token;
+        break;
+    case PathFailure::none:
+    case PathFailure::not_container:
+        error_message = "Expected JSON object or list for \""s + token + "\"";
+        break;
+    }
+    return Result{ParseError{std::move(error_message)}, "When evaluating JSON path \""s + std::string(pointer) + "\": ", {}};
+}
+
+// Shared evaluation of Path and StaticPath over their segment tables.
+template<typename Derived>
+class PathBase
+{
+public:
+    // The addressed value or nullptr, without building an error.
+    constexpr const JsonValue *find(const JsonValue &json_value) const noexcept
+    {
+        std::size_t failed_segment = 0;
+        PathFailure failure = PathFailure::none;
+        return walk_path(json_value, self().segments(), self().keys(), failed_segment, failure);
+    }
+
+    Parser<std::reference_wrapper<const JsonValue>> operator()(const JsonValue &json_value) const
+    {
+        return get(json_value, [] (const JsonValue &found) {
+            return Parser<std::reference_wrapper<const JsonValue>>{std::cref(found)};
+        });
+    }
+
+    // The addressed value as JsonObject/JsonString/JsonNumber/JsonList, like parse_field.
+    template<typename T>
+    Parser<T> get(const JsonValue &json_value) const
+    {
+        return get(json_value, json_type_parser<T>());
+    }
+
+    // The addressed value decoded by parser: (const JsonValue &) -> Parser<T>.
+    template<typename Func>
+    auto get(const JsonValue &json_value, const Func &parser) const
+    {
+        using RetVal = std::remove_cvref_t<std::invoke_result_t<const Func &, const JsonValue &>>;
+        std::size_t failed_segment = 0;
+        PathFailure failure = PathFailure::none;
+        const JsonValue *found = walk_path(json_value, self().segments(), self().keys(), failed_segment, failure);
+        if (!found)
+        {
+            return path_error<RetVal>(self().pointer(), self().segments(), self().keys(), failed_segment, failure);
+        }
+        RetVal result = parser(*found);
+        if (std::holds_alternative<ParseError>(result.value))
+        {
+            using namespace std::literals;
+            result.error_prefix = "When evaluating JSON path \""s + std::string(self().pointer()) + "\": " + std::move(result.error_prefix);
+        }
+        return result;
+    }
+
+private:
+    constexpr const Derived &self() const noexcept
+    {
+        return static_cast<const Derived &>(*this);
+    }
+};
+
+} // namespace detail
+
+// JSON Pointer parsed once at runtime, e.g. from configuration. Throws std::invalid_argument for a
+// malformed pointer.
+class Path final : public detail::PathBase<Path>
+{
+public:
+    explicit Path(std::string_view pointer)
+        : pointer_(pointer)
+    {
+        detail::for_each_pointer_token(pointer_, [this] (std::string_view token) {
+            segments_.push_back(PathSegment{
+                .key_hash = detail::hash_key(token),
+                .key_offset = static_cast<std::uint32_t>(keys_.size()),
+                .key_size = static_cast<std::uint32_t>(token.size()),
+                .index = detail::pointer_index(token),
+            });
+            keys_ += token;
+        });
+    }
+
+    std::string_view pointer() const noexcept
+    {
+        return pointer_;
+    }
+
+    std::span<const PathSegment> segments() const noexcept
+    {
+        return segments_;
+    }
+
+    const char *keys() const noexcept
+    {
+        return keys_.data();
+    }
+
+private:
+    std::string pointer_;
+    std::string keys_;
+    std::vector<PathSegment> segments_;
+};
+
+// JSON Pointer parsed and validated at compile time; a malformed pointer fails compilation.
+template<PathText Text, std::size_t SegmentCount, std::size_t KeyCount>
+class StaticPath final : public detail::PathBase<StaticPath<Text, SegmentCount, KeyCount>>
+{
+public:
+    consteval StaticPath()
+    {
+        std::size_t segment = 0;
+        std::size_t offset = 0;
+        detail::for_each_pointer_token(Text.view(), [&] (std::string_view token) {
+            segments_[segment++] = PathSegment{
+                .key_hash = detail::hash_key(token),
+                .key_offset = static_cast<std::uint32_t>(offset),
+                .key_size = static_cast<std::uint32_t>(token.size()),
+                .index = detail::pointer_index(token),
+            };
+            offset = std::copy(token.begin(), token.end(), keys_.begin() + offset) - keys_.begin();
+        });
+    }
+
+    constexpr std::string_view pointer() const noexcept
+    {
+        return Text.view();
+    }
+
+    constexpr std::span<const PathSegment> segments() const noexcept
+    {
+        return segments_;
+    }
+
+    constexpr const char *keys() const noexcept
+    {
+        return keys_.data();
+    }
+
+private:
+    std::array<PathSegment, SegmentCount> segments_{};
+    // One spare byte keeps data() valid for an all-empty-token pointer.
+    std::array<char, KeyCount + 1> keys_{};
+};
+
+namespace detail
+{
+
+template<PathText Text>
+consteval std::pair<std::size_t, std::size_t> measure_path()
+{
+    std::size_t segments = 0;
+    std::size_t keys = 0;
+    for_each_pointer_token(Text.view(), [&] (std::string_view token) {
+        ++segments;
+        keys += token.size();
+    });
+    return {segments, keys};
+}
+
+} // namespace detail
+
+template<PathText Text>
+inline constexpr StaticPath<Text, detail::measure_path<Text>().first, detail::measure_path<Text>().second> path{};
+
+// Values found by PathSet::evaluate, in the order the paths were given; nullptr where a path does
+// not resolve. Reusing the results across evaluations keeps their storage.
+struct PathResults final
+{
+    const JsonValue *operator[](std::size_t idx) const noexcept
+    {
+        return values[idx];
+    }
+
+    std::vector<const JsonValue *> values;
+    // Per trie node: whether it was reached, so that only the first of duplicate keys counts.
+    std::vector<std::uint8_t> reached;
+};
+
+// Many paths evaluated in one traversal: the paths are merged into a trie, so shared prefixes are
+// walked once and every object on the way is scanned once, hashing each key a single time and
+// matching it against the precomputed hashes of all tokens wanted at that level.
+class PathSet final
+{
+public:
+    explicit PathSet(std::initializer_list<std::string_view> pointers)
+        : PathSet(std::vector<std::string_view>(pointers))
+    {
+    }
+
+    explicit PathSet(const std::vector<std::string_view> &pointers)
+        : nodes_(1)
+        , path_count_(pointers.size())
+    {
+        for (std::size_t path = 0; path < pointers.size(); ++path)
+        {
+            std::uint32_t node = 0;
+            detail::for_each_pointer_token(pointers[path], [&] (std::string_view token) {
+                node = child(node, token);
+            });
+            nodes_[node].terminals.push_back(static_cast<std::uint32_t>(path));
+        }
+    }
+
+    std::size_t size() const noexcept
+    {
+        return path_count_;
+    }
+
+    void evaluate(const JsonValue &json_value, PathResults &results) const
+    {
+        results.values.assign(path_count_, nullptr);
+        results.reached.assign(nodes_.size(), 0);
+        visit(0, json_value, results);
+    }
+
+    PathResults evaluate(const JsonValue &json_value) const
+    {
+        PathResults results;
+        evaluate(json_value, results);
+        return results;
+    }
+
+private:
+    static constexpr std::size_t hashed_children_threshold = 4;
+
+    struct Child final
+    {
+        std::uint64_t key_hash;
+        std::uint32_t key_offset;
+        std::uint32_t key_size;
+        std::size_t index;
+        std::uint32_t node;
+    };
+
+    struct Node final
+    {
+        std::vector<Child> children;
+        std::vector<std::uint32_t> terminals;
+    };
+
+    std::uint32_t child(std::uint32_t node, std::string_view token)
+    {
+        const std::uint64_t hash = detail::hash_key(token);
+        for (const Child &existing : nodes_[node].children)
+        {
+            if (existing.key_hash == hash && key(existing) == token)
+            {
+                return existing.node;
+            }
+        }
+        const auto created = static_cast<std::uint32_t>(nodes_.size());
+        nodes_[node].children.push_back(Child{
+            .key_hash = hash,
+            .key_offset = static_cast<std::uint32_t>(keys_.size()),
+            .key_size = static_cast<std::uint32_t>(token.size()),
+            .index = detail::pointer_index(token),
+            .node = created,
+        });
+        keys_ += token;
+        nodes_.emplace_back();
+        return created;
+    }
+
+    std::string_view key(const Child &child) const noexcept
+    {
+        return std::string_view{keys_}.substr(child.key_offset, child.key_size);
+    }
+
+    void visit(std::uint32_t node_idx, const JsonValue &json_value, PathResults &results) const
+    {
+        const Node &node = nodes_[node_idx];
+        results.reached[node_idx] = 1;
+        for (const std::uint32_t path : node.terminals)
+        {
+            results.values[path] = &json_value;
+        }
+        if (node.children.empty())
+        {
+            return;
+        }
+        if (const auto *json_object = std::get_if<JsonObject>(&json_value.value))
+        {
+            // Hashing a key costs about as much as a few length-guarded comparisons, so it only
+            // pays off when many tokens are wanted from the same object.
+            const bool hashed = node.children.size() > hashed_children_threshold;
+            for (const auto &[field_key, field_value] : *json_object)
+            {
+                const std::uint64_t hash = hashed ? detail::hash_key(field_key) : 0;
+                for (const Child &child : node.children)
+                {
+                    if ((hashed ? child.key_hash == hash : child.key_size == field_key.size())
+                        && !results.reached[child.node] && key(child) == field_key)
+                    {
+                        visit(child.node, field_value, results);
+                        break;
+                    }
+                }
+            }
+        }
+        else if (const auto *json_list = std::get_if<JsonList>(&json_value.value))
+        {
+            for (const Child &child : node.children)
+            {
+                if (child.index < json_list->size())
+                {
+                    visit(child.node, (*json_list)[child.index], results);
+                }
+            }
+        }
+    }
+
+    std::vector<Node> nodes_;
+    std::string keys_;
+    std::size_t path_count_;
+};
+
+} // namespace json
@@ -0,0 +1,723 @@
+#pragma once
+
+#include "json.hpp"
+
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <variant>
+#include <vector>
+
+namespace json
+{
+
+namespace detail
+{
+
+struct PersistentNode;
+
+} // namespace detail
+
+// Immutable JSON value whose objects and lists share structure between versions. Objects are hash
+// array mapped tries keyed by detail::hash_key, lists are 32-way radix-balanced trees, and updates
+// copy only the nodes on the path to the change; everything else is shared by reference count.
+// Below the persistent levels values are ordinary JsonValue leaves, so the json.hpp combinators
+// run on them as they are. Objects do not keep the key order of the document.
+class PersistentJson final
+{
+public:
+    // Empty persistent object.
+    PersistentJson();
+
+    static PersistentJson leaf(JsonValue json_value);
+    static PersistentJson list();
+
+    // Objects and lists down to persistent_depth levels become persistent nodes, the rest leaves.
+    // For duplicate keys the first occurrence wins, as with parse_field.
+    static PersistentJson from_json(const JsonValue &json_value, std::size_t persistent_depth = 1);
+
+    bool is_object() const noexcept;
+    bool is_list() const noexcept;
+
+    // The JsonValue of a leaf, nullptr for persistent objects and lists.
+    const JsonValue *leaf() const noexcept;
+
+    // Number of fields or elements of a persistent object or list, 0 for a leaf.
+    std::size_t size() const noexcept;
+
+    const PersistentJson *find(std::string_view key) const noexcept;
+    const PersistentJson *at(std::size_t idx) const noexcept;
+
+    [[nodiscard]] PersistentJson set(std::string_view key, PersistentJson value) const;
+    [[nodiscard]] PersistentJson set(std::size_t idx, PersistentJson value) const;
+    [[nodiscard]] PersistentJson push_back(PersistentJson value) const;
+    // Sets the value at a path of keys through persistent objects.
+    [[nodiscard]] PersistentJson set_in(std::span<const std::string_view> keys, PersistentJson value) const;
+
+    template<typename Func>
+    void for_each_field(Func &&func) const;
+
+    template<typename Func>
+    void for_each_element(Func &&func) const;
+
+    JsonValue to_json() const;
+
+    // True when both refer to the same node, i.e. the subtree was shared rather than copied.
+    bool shares_node_with(const PersistentJson &other) const noexcept
+    {
+        return node_ == other.node_;
+    }
+
+private:
+    friend class JsonDocument;
+
+    explicit PersistentJson(std::shared_ptr<const detail::PersistentNode> node) noexcept
+        : node_(std::move(node))
+    {
+    }
+
+    std::shared_ptr<const detail::PersistentNode> node_;
+};
+
+namespace detail
+{
+
+struct HamtNode;
+struct VectorNode;
+
+struct HamtEntry final
+{
+    std::uint64_t hash;
+    std::string key;
+    PersistentJson value;
+};
+
+// Bitmap-indexed node: bit i of bitmap says whether the 5-bit hash chunk i is present, and slots
+// holds the present ones in chunk order. Past 64 bits of hash a node is a plain collision list.
+struct HamtNode final
+{
+    std::uint32_t bitmap = 0;
+    std::vector<std::variant<HamtEntry, std::shared_ptr<const HamtNode>>> slots;
+};
+
+// Inner nodes hold children, leaf nodes hold up to 32 values.
+struct VectorNode final
+{
+    std::vector<std::shared_ptr<const VectorNode>> children;
+    std::vector<PersistentJson> values;
+};
+
+struct PersistentObject final
+{
+    std::shared_ptr<const HamtNode> root;
+    std::size_t size = 0;
+};
+
+struct PersistentList final
+{
+    std::shared_ptr<const VectorNode> root;
+    std::size_t size = 0;
+    unsigned shift = 0;
+};
+
+struct PersistentNode final
+{
+    std::variant<JsonValue, PersistentObject, PersistentList> value;
+};
+
+inline constexpr unsigned hamt_bits = 5;
+inline constexpr std::uint32_t hamt_mask = (1u << hamt_bits) - 1;
+
+inline const PersistentJson *hamt_find(const HamtNode *node, std::string_view key, std::uint64_t hash) noexcept
+{
+    for (unsigned shift = 0; node; shift += hamt_bits)
+    {
+        if (shift >= 64)
+        {
+            for (const auto &slot : node->slots)
+            {
+                const HamtEntry &entry = std::get<HamtEntry>(slot);
+                if (entry.key == key)
+                {
+                    return &entry.value;
+                }
+            }
+            return nullptr;
+        }
+        const std::uint32_t bit = 1u << ((hash >> shift) & hamt_mask);
+        if (!(node->bitmap & bit))
+        {
+            return nullptr;
+        }
+        const auto &slot = node->slots[std::popcount(node->bitmap & (bit - 1))];
+        if (const auto *entry = std::get_if<HamtEntry>(&slot))
+        {
+            return entry->hash == hash && entry->key == key ? &entry->value : nullptr;
+        }
+        node = std::get<std::shared_ptr<const HamtNode>>(slot).get();
+    }
+    return nullptr;
+}
+
+// Copy of node with entry set; added tells whether the key was new.
+inline std::shared_ptr<const HamtNode> hamt_set(const HamtNode *node, HamtEntry entry, unsigned shift, bool &added)
+{
+    auto result = node ? std::make_shared<HamtNode>(*node) : std::make_shared<HamtNode>();
+    if (shift >= 64)
+    {
+        for (auto &slot : result->slots)
+        {
+            if (auto &existing = std::get<HamtEntry>(slot); existing.key == entry.key)
+            {
+                existing.value = std::move(entry.value);
+                return result;
+            }
+        }
+        result->slots.emplace_back(std::move(entry));
+        added = true;
+        return result;
+    }
+    const std::uint32_t bit = 1u << ((entry.hash >> shift) & hamt_mask);
+    const auto position = result->slots.begin() + std::popcount(result->bitmap & (bit - 1));
+    if (!(result->bitmap & bit))
+    {
+        result->bitmap |= bit;
+        result->slots.emplace(position, std::move(entry));
+        added = true;
+        return result;
+    }
+    if (auto *existing = std::get_if<HamtEntry>(&*position))
+    {
+        if (existing->hash == entry.hash && existing->key == entry.key)
+        {
+            existing->value = std::move(entry.value);
+            return result;
+        }
+        // Two keys share this chunk: push both one level down.
+        bool ignored = false;
+        const auto child = hamt_set(nullptr, std::move(*existing), shift + hamt_bits, ignored);
+        *position = hamt_set(child.get(), std::move(entry), shift + hamt_bits, added);
+        return result;
+    }
+    *position = hamt_set(std::get<std::shared_ptr<const HamtNode>>(*position).get(), std::move(entry), shift + hamt_bits, added);
+    return result;
+}
+
+template<typename Func>
+void hamt_for_each(const HamtNode *node, Func &func)
+{
+    if (!node)
+    {
+        return;
+    }
+    for (const auto &slot : node->slots)
+    {
+        if (const auto *entry = std::get_if<HamtEntry>(&slot))
+        {
+            func(std::string_view{entry->key}, entry->value);
+        }
+        else
+        {
+            hamt_for_each(std::get<std::shared_ptr<const HamtNode>>(slot).get(), func);
+        }
+    }
+}
+
+inline std::shared_ptr<const VectorNode> vector_set(const VectorNode &node, unsigned shift, std::size_t idx, PersistentJson value)
+{
+    auto result = std::make_shared<VectorNode>(node);
+    if (shift == 0)
+    {
+        result->values[idx & hamt_mask] = std::move(value);
+    }
+    else
+    {
+        auto &child = result->children[(idx >> shift) & hamt_mask];
+        child = vector_set(*child, shift - hamt_bits, idx, std::move(value));
+    }
+    return result;
+}
+
+inline std::shared_ptr<const VectorNode> vector_push(const VectorNode *node, unsigned shift, std::size_t idx, PersistentJson value)
+{
+    auto result = node ? std::make_shared<VectorNode>(*node) : std::make_shared<VectorNode>();
+    if (shift == 0)
+    {
+        result->values.push_back(std::move(value));
+        return result;
+    }
+    const std::size_t child_idx = (idx >> shift) & hamt_mask;
+    if (child_idx < result->children.size())
+    {
+        result->children[child_idx] = vector_push(result->children[child_idx].get(), shift - hamt_bits, idx, std::move(value));
+    }
+    else
+    {
+        result->children.push_back(vector_push(nullptr, shift - hamt_bits, idx, std::move(value)));
+    }
+    return result;
+}
+
+template<typename Func>
+void vector_for_each(const VectorNode *node, Func &func)
+{
+    if (!node)
+    {
+        return;
+    }
+    for (const auto &child : node->children)
+    {
+        vector_for_each(child.get(), func);
+    }
+    for (const PersistentJson &value : node->values)
+    {
+        func(value);
+    }
+}
+
+inline const std::shared_ptr<const PersistentNode> &empty_persistent_object()
+{
+    static const auto node = std::make_shared<const PersistentNode>(PersistentNode{PersistentObject{}});
+    return node;
+}
+
+} // namespace detail
+
+inline PersistentJson::PersistentJson()
+    : node_(detail::empty_persistent_object())
+{
+}
+
+inline PersistentJson PersistentJson::leaf(JsonValue json_value)
+{
+    return PersistentJson{std::make_shared<const detail::PersistentNode>(detail::PersistentNode{std::move(json_value)})};
+}
+
+inline PersistentJson PersistentJson::list()
+{
+    return PersistentJson{std::make_shared<const detail::PersistentNode>(detail::PersistentNode{detail::PersistentList{}})};
+}
+
+inline PersistentJson PersistentJson::from_json(const JsonValue &json_value, std::size_t persistent_depth)
+{
+    if (persistent_depth == 0)
+    {
+        return leaf(json_value);
+    }
+    if (const auto *json_object = std::get_if<JsonObject>(&json_value.value))
+    {
+        PersistentJson result;
+        for (const auto &[key, value] : *json_object)
+        {
+            if (!result.find(key))
+            {
+                result = result.set(key, from_json(value, persistent_depth - 1));
+            }
+        }
+        return result;
+    }
+    if (const auto *json_list = std::get_if<JsonList>(&json_value.value))
+    {
+        PersistentJson result = list();
+        for (const JsonValue &value : *json_list)
+        {
+            result = result.push_back(from_json(value, persistent_depth - 1));
+        }
+        return result;
+    }
+    return leaf(json_value);
+}
+
+inline bool PersistentJson::is_object() const noexcept
+{
+    return std::holds_alternative<detail::PersistentObject>(node_->value);
+}
+
+inline bool PersistentJson::is_list() const noexcept
+{
+    return std::holds_alternative<detail::PersistentList>(node_->value);
+}
+
+inline const JsonValue *PersistentJson::leaf() const noexcept
+{
+    return std::get_if<JsonValue>(&node_->value);
+}
+
+inline std::size_t PersistentJson::size() const noexcept
+{
+    if (const auto *object = std::get_if<detail::PersistentObject>(&node_->value))
+    {
+        return object->size;
+    }
+    if (const auto *list = std::get_if<detail::PersistentList>(&node_->value))
+    {
+        return list->size;
+    }
+    return 0;
+}
+
+inline const PersistentJson *PersistentJson::find(std::string_view key) const noexcept
+{
+    const auto *object = std::get_if<detail::PersistentObject>(&node_->value);
+    return object ? detail::hamt_find(object->root.get(), key, detail::hash_key(key)) : nullptr;
+}
+
+inline const PersistentJson *PersistentJson::at(std::size_t idx) const noexcept
+{
+    const auto *list = std::get_if<detail::PersistentList>(&node_->value);
+    if (!list || idx >= list->size)
+    {
+        return nullptr;
+    }
+    const detail::VectorNode *node = list->root.get();
+    for (unsigned shift = list->shift; shift > 0; shift -= detail::hamt_bits)
+    {
+        node = node->children[(idx >> shift) & detail::hamt_mask].get();
+    }
+    return &node->values[idx & detail::hamt_mask];
+}
+
+inline PersistentJson PersistentJson::set(std::string_view key, PersistentJson value) const
+{
+    const auto *object = std::get_if<detail::PersistentObject>(&node_->value);
+    if (!object)
+    {
+        throw std::invalid_argument("PersistentJson::set with a key needs a persistent object");
+    }
+    bool added = false;
+    auto root = detail::hamt_set(object->root.get(), detail::HamtEntry{detail::hash_key(key), std::string(key), std::move(value)}, 0, added);
+    return PersistentJson{std::make_shared<const detail::PersistentNode>(detail::PersistentNode{
+        detail::PersistentObject{std::move(root), object->size + (added ? 1 : 0)}
+    })};
+}
+
+inline PersistentJson PersistentJson::set(std::size_t idx, PersistentJson value) const
+{
+    const auto *list = std::get_if<detail::PersistentList>(&node_->value);
+    if (!list || idx >= list->size)
+    {
+        throw std::out_of_range("PersistentJson::set with an index needs a persistent list element");
+    }
+    return PersistentJson{std::make_shared<const detail::PersistentNode>(detail::PersistentNode{
+        detail::PersistentList{detail::vector_set(*list->root, list->shift, idx, std::move(value)), list->size, list->shift}
+    })};
+}
+
+inline PersistentJson PersistentJson::push_back(PersistentJson value) const
+{
+    const auto *list = std::get_if<detail::PersistentList>(&node_->value);
+    if (!list)
+    {
+        throw std::invalid_argument("PersistentJson::push_back needs a persistent list");
+    }
+    detail::PersistentList result{list->root, list->size + 1, list->shift};
+    if (list->size == (std::size_t{1} << (list->shift + detail::hamt_bits)))
+    {
+        // The tree is full: grow a level, the old root becomes the first child.
+        auto root = std::make_shared<detail::VectorNode>();
+        root->children.push_back(list->root);
+        result.shift += detail::hamt_bits;
+        result.root = detail::vector_push(root.get(), result.shift, list->size, std::move(value));
+    }
+    else
+    {
+        result.root = detail::vector_push(list->root.get(), list->shift, list->size, std::move(value));
+    }
+    return PersistentJson{std::make_shared<const detail::PersistentNode>(detail::PersistentNode{std::move(result)})};
+}
+
+inline PersistentJson PersistentJson::set_in(std::span<const std::string_view> keys, PersistentJson value) const
+{
+    if (keys.empty())
+    {
+        return value;
+    }
+    const PersistentJson *child = find(keys.front());
+    if (keys.size() > 1 && !child)
+    {
+        throw std::out_of_range("PersistentJson::set_in: no field \"" + std::string(keys.front()) + "\"");
+    }
+    return set(keys.front(), keys.size() > 1 ? child->set_in(keys.subspan(1), std::move(value)) : std::move(value));
+}
+
+template<typename Func>
+void PersistentJson::for_each_field(Func &&func) const
+{
+    if (const auto *object = std::get_if<detail::PersistentObject>(&node_->value))
+    {
+        detail::hamt_for_each(object->root.get(), func);
+    }
+}
+
+template<typename Func>
+void PersistentJson::for_each_element(Func &&func) const
+{
+    if (const auto *list = std::get_if<detail::PersistentList>(&node_->value))
+    {
+        detail::vector_for_each(list->root.get(), func);
+    }
+}
+
+inline JsonValue PersistentJson::to_json() const
+{
+    if (const JsonValue *json_value = leaf())
+    {
+        return *json_value;
+    }
+    if (is_object())
+    {
+        JsonObject json_object;
+        json_object.reserve(size());
+        for_each_field([&json_object] (std::string_view key, const PersistentJson &value) {
+            json_object.emplace_back(std::string(key), value.to_json());
+        });
+        return JsonValue{std::move(json_object)};
+    }
+    JsonList json_list;
+    json_list.reserve(size());
+    for_each_element([&json_list] (const PersistentJson &value) {
+        json_list.push_back(value.to_json());
+    });
+    return JsonValue{std::move(json_list)};
+}
+
+namespace detail
+{
+
+// One published version of a JsonDocument root. pending_readers settles the readers that were
+// still counted in the document's word when this version was replaced; see JsonDocument.
+struct PublishedRoot final
+{
+    std::shared_ptr<const PersistentNode> node;
+    std::atomic<std::int64_t> pending_readers{0};
+};
+
+} // namespace detail
+
+// Shared root of a document that many threads read and a few update. Readers take a snapshot,
+// which stays valid and unchanged however long they hold it; writers publish a new version with
+// an atomic pointer swap. std::atomic<std::shared_ptr> is not lock-free in libstdc++, so the root
+// is one 64-bit word packing the published version with the number of readers currently copying
+// its shared_ptr (a split reference count). A replaced version is deleted by whoever settles its
+// last reader, so it is never freed while a reader still uses it.
+//
+// Both halves of the word have limits, and neither is left to an assert:
+// - a version whose address does not fit in 48 bits (tagged pointers under ARM TBI/MTE or
+//   HWASan, 57-bit addresses under LA57) switches the document to a mutex for good;
+// - readers only hold their count while copying the shared_ptr, and a reader that would take
+//   it past 65535 yields until others are done instead of wrapping it.
+class JsonDocument final
+{
+public:
+    explicit JsonDocument(PersistentJson root = {})
+        : word_(0)
+    {
+        auto *fresh = new detail::PublishedRoot{std::move(root.node_)};
+        if (fits(fresh))
+        {
+            word_.store(pack(fresh), std::memory_order_release);
+        }
+        else
+        {
+            locked_root_ = std::move(fresh->node);
+            delete fresh;
+            locked_.store(true, std::memory_order_release);
+        }
+    }
+
+    JsonDocument(const JsonDocument &) = delete;
+    JsonDocument &operator=(const JsonDocument &) = delete;
+
+    ~JsonDocument()
+    {
+        delete published(word_.load(std::memory_order_acquire));
+    }
+
+    PersistentJson snapshot() const
+    {
+        {
+            const Reader reader{*this};
+            if (reader.root)
+            {
+                return PersistentJson{reader.root->node};
+            }
+        }
+        std::lock_guard lock{mutex_};
+        return PersistentJson{locked_root_};
+    }
+
+    void store(PersistentJson root)
+    {
+        update([&root] (const PersistentJson &) {
+            return root;
+        });
+    }
+
+    // Applies func (const PersistentJson & -> PersistentJson) to the current version and publishes
+    // the result, retrying if another writer got in first. Returns the published version. func
+    // runs without counting as a reader, so slow updates do not hold up the reader count.
+    template<typename Func>
+    PersistentJson update(Func &&func)
+    {
+        while (!locked_.load(std::memory_order_acquire))
+        {
+            // Holding base keeps its node alive, so its address cannot be reused by a newer
+            // version and mistaken for it below.
+            const PersistentJson base = snapshot();
+            PersistentJson updated = func(base);
+            auto *fresh = new detail::PublishedRoot{updated.node_};
+            if (!fits(fresh))
+            {
+                delete fresh;
+                switch_to_lock();
+                break;
+            }
+            const Reader reader{*this};
+            // The reader count in the word changes as readers come and go; only a new version
+            // makes the update start over.
+            std::uint64_t expected = word_.load(std::memory_order_relaxed);
+            while (reader.root && reader.root->node == base.node_ && published(expected) == reader.root)
+            {
+                if (word_.compare_exchange_weak(expected, pack(fresh), std::memory_order_acq_rel, std::memory_order_relaxed))
+                {
+                    retire(expected);
+                    return updated;
+                }
+            }
+            delete fresh;
+        }
+        std::lock_guard lock{mutex_};
+        PersistentJson updated = func(PersistentJson{locked_root_});
+        locked_root_ = updated.node_;
+        return updated;
+    }
+
+    // Whether snapshots and updates still avoid the mutex; false once a version did not fit.
+    bool is_lock_free() const noexcept
+    {
+        return std::atomic<std::uint64_t>::is_always_lock_free && !locked_.load(std::memory_order_acquire);
+    }
+
+private:
+    // Low 48 bits: the PublishedRoot, or 0 once the document uses the mutex; high 16 bits: readers
+    // between acquire() and release(), up to max_readers at a time.
+    static constexpr unsigned pointer_bits = 48;
+    static constexpr std::uint64_t pointer_mask = (std::uint64_t{1} << pointer_bits) - 1;
+    static constexpr std::uint64_t reader_unit = std::uint64_t{1} << pointer_bits;
+    static constexpr std::uint64_t max_readers = ~std::uint64_t{0} >> pointer_bits;
+
+    static_assert(sizeof(void *) == sizeof(std::uint64_t), "JsonDocument packs a pointer into 64 bits");
+
+    static bool fits(const detail::PublishedRoot *root) noexcept
+    {
+        return (reinterpret_cast<std::uintptr_t>(root) & ~pointer_mask) == 0;
+    }
+
+    static std::uint64_t pack(detail::PublishedRoot *root) noexcept
+    {
+        return reinterpret_cast<std::uintptr_t>(root);
+    }
+
+    static detail::PublishedRoot *published(std::uint64_t word) noexcept
+    {
+        return reinterpret_cast<detail::PublishedRoot *>(static_cast<std::uintptr_t>(word & pointer_mask));
+    }
+
+    // Counts the caller as a reader of the current version; the version stays alive until release().
+    // Returns nullptr once the document uses the mutex.
+    detail::PublishedRoot *acquire() const noexcept
+    {
+        std::uint64_t current = word_.load(std::memory_order_relaxed);
+        while (true)
+        {
+            if ((current >> pointer_bits) == max_readers)
+            {
+                std::this_thread::yield();
+                current = word_.load(std::memory_order_relaxed);
+            }
+            else if (word_.compare_exchange_weak(current, current + reader_unit, std::memory_order_acquire, std::memory_order_relaxed))
+            {
+                return published(current);
+            }
+        }
+    }
+
+    void release(detail::PublishedRoot *root) const noexcept
+    {
+        std::uint64_t current = word_.load(std::memory_order_relaxed);
+        while (published(current) == root)
+        {
+            if (word_.compare_exchange_weak(current, current - reader_unit, std::memory_order_release, std::memory_order_relaxed))
+            {
+                return;
+            }
+        }
+        // Replaced in the meantime: retire() moved this reader's count to pending_readers. The
+        // mutex word is never replaced, so that is always a real version.
+        if (root && root->pending_readers.fetch_sub(1, std::memory_order_acq_rel) == 1)
+        {
+            delete root;
+        }
+    }
+
+    // Counts as a reader of the current version for its lifetime.
+    struct Reader final
+    {
+        explicit Reader(const JsonDocument &document_) noexcept
+            : document(document_)
+            , root(document_.acquire())
+        {
+        }
+        Reader(const Reader &) = delete;
+        Reader &operator=(const Reader &) = delete;
+        ~Reader()
+        {
+            document.release(root);
+        }
+
+        const JsonDocument &document;
+        detail::PublishedRoot *root;
+    };
+
+    // Hands a replaced version the readers still counted in its word; the last one out deletes it.
+    static void retire(std::uint64_t word) noexcept
+    {
+        detail::PublishedRoot *root = published(word);
+        const auto readers = static_cast<std::int64_t>(word >> pointer_bits);
+        if (root->pending_readers.fetch_add(readers, std::memory_order_acq_rel) + readers == 0)
+        {
+            delete root;
+        }
+    }
+
+    // Moves the current version behind the mutex. Writers that still hold the old word fail their
+    // compare-exchange against 0 and come back through the mutex.
+    void switch_to_lock()
+    {
+        std::lock_guard lock{mutex_};
+        if (locked_.load(std::memory_order_relaxed))
+        {
+            return;
+        }
+        const std::uint64_t last = word_.exchange(0, std::memory_order_acq_rel);
+        locked_root_ = published(last)->node;
+        locked_.store(true, std::memory_order_release);
+        retire(last);
+    }
+
+    mutable std::atomic<std::uint64_t> word_;
+    std::atomic<bool> locked_{false};
+    mutable std::mutex mutex_;
+    std::shared_ptr<const detail::PersistentNode> locked_root_;
+};
+
+} // namespace json
@@ -0,0 +1,267 @@
+#pragma once
+
+#include "json.hpp"
+
+#include <bit>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <variant>
+#include <vector>
+
+namespace json
+{
+
+// Schemas that are only known at runtime, e.g. loaded from configuration. A schema is compiled
+// once into a flat instruction array and a hash table over it; parsing an object is then one loop
+// over its keys: hash -> instruction -> type check -> conversion into the field's slot.
+
+enum class SchemaType : std::uint8_t
+{
+    number,
+    integer,
+    string,
+    list,
+    object,
+    any,
+};
+
+constexpr std::string_view to_string(SchemaType type) noexcept
+{
+    switch (type)
+    {
+    case SchemaType::number: return "JSON number";
+    case SchemaType::integer: return "integral JSON number";
+    case SchemaType::string: return "JSON string";
+    case SchemaType::list: return "JSON list";
+    case SchemaType::object: return "JSON object";
+    case SchemaType::any: return "JSON value";
+    }
+    return "JSON value";
+}
+
+struct SchemaField final
+{
+    std::string name;
+    SchemaType type = SchemaType::any;
+    bool required = true;
+};
+
+// Value of one slot: number -> JsonNumber, integer -> std::int64_t, string -> std::string_view,
+// list/object/any -> pointer. Strings, lists and objects point into the parsed JsonValue, which
+// must outlive the row. Absent optional fields stay std::monostate.
+using SchemaValue = std::variant<std::monostate, JsonNumber, std::int64_t, std::string_view, const JsonList *, const JsonObject *, const JsonValue *>;
+
+// Slots in schema field order. Reusing a row across parses keeps its storage.
+struct SchemaRow final
+{
+    template<typename T>
+    const T *get(std::size_t slot) const noexcept
+    {
+        return std::get_if<T>(&values[slot]);
+    }
+
+    std::vector<SchemaValue> values;
+};
+
+class CompiledSchema final
+{
+public:
+    CompiledSchema(std::string class_name, const std::vector<SchemaField> &fields)
+        : class_name_(std::move(class_name))
+        , table_(std::bit_ceil(fields.size() * 2 + 1), 0)
+    {
+        instructions_.reserve(fields.size());
+        for (const SchemaField &field : fields)
+        {
+            if (slot(field.name))
+            {
+                throw std::invalid_argument("Duplicate field \"" + field.name + "\" in schema for " + class_name_);
+            }
+            const Instruction instruction{
+                .hash = detail::hash_key(field.name),
+                .name_offset = static_cast<std::uint32_t>(name_pool_.size()),
+                .name_size = static_cast<std::uint32_t>(field.name.size()),
+                .slot = static_cast<std::uint32_t>(instructions_.size()),
+                .type = field.type,
+                .required = field.required,
+            };
+            name_pool_ += field.name;
+            required_count_ += field.required ? 1 : 0;
+            std::size_t position = instruction.hash & (table_.size() - 1);
+            while (table_[position])
+            {
+                position = (position + 1) & (table_.size() - 1);
+            }
+            table_[position] = static_cast<std::uint32_t>(instructions_.size() + 1);
+            instructions_.push_back(instruction);
+        }
+    }
+
+    std::size_t size() const noexcept
+    {
+        return instructions_.size();
+    }
+
+    std::optional<std::size_t> slot(std::string_view name) const noexcept
+    {
+        if (const Instruction *instruction = find(name, detail::hash_key(name)))
+        {
+            return instruction->slot;
+        }
+        return std::nullopt;
+    }
+
+    // Fills row and returns the number of fields found. Unknown keys are ignored and the first
+    // occurrence of a key wins, as with parse_field.
+    Parser<std::size_t> parse_into(const JsonValue &json_value, SchemaRow &row) const
+    {
+        using namespace std::literals;
+        const auto *json_object = std::get_if<JsonObject>(&json_value.value);
+        if (!json_object)
+        {
+            return Parser<std::size_t>{ParseError{"Expected JSON object for " + class_name_}};
+        }
+        row.values.assign(instructions_.size(), std::monostate{});
+        std::size_t found = 0;
+        std::size_t required_found = 0;
+        for (const auto &[key, value] : *json_object)
+        {
+            const Instruction *instruction = find(key, detail::hash_key(key));
+            if (!instruction || !std::holds_alternative<std::monostate>(row.values[instruction->slot]))
+            {
+                continue;
+            }
+            if (!convert(instruction->type, value, row.values[instruction->slot]))
+            {
+                return Parser<std::size_t>{
+                    ParseError{"Expected "s + std::string(to_string(instruction->type))},
+                    "When parsing JSON object for "s + class_name_ + ": When parsing JSON object field \"" + std::string(key) + "\": ",
+                    {},
+                };
+            }
+            ++found;
+            required_found += instruction->required ? 1 : 0;
+        }
+        if (required_found != required_count_)
+        {
+            for (const Instruction &instruction : instructions_)
+            {
+                if (instruction.required && std::holds_alternative<std::monostate>(row.values[instruction.slot]))
+                {
+                    return Parser<std::size_t>{
+                        ParseError{"Expected JSON object field \""s + std::string(name(instruction)) + "\""},
+                        "When parsing JSON object for "s + class_name_ + ": ",
+                        {},
+                    };
+                }
+            }
+        }
+        return Parser<std::size_t>{found};
+    }
+
+    Parser<SchemaRow> operator()(const JsonValue &json_value) const
+    {
+        SchemaRow row;
+        auto result = parse_into(json_value, row);
+        if (auto *parse_error = std::get_if<ParseError>(&result.value))
+        {
+            return Parser<SchemaRow>{std::move(*parse_error), std::move(result.error_prefix), std::move(result.error_suffix)};
+        }
+        return Parser<SchemaRow>{std::move(row)};
+    }
+
+private:
+    struct Instruction final
+    {
+        std::uint64_t hash;
+        std::uint32_t name_offset;
+        std::uint32_t name_size;
+        std::uint32_t slot;
+        SchemaType type;
+        bool required;
+    };
+
+    std::string_view name(const Instruction &instruction) const noexcept
+    {
+        return std::string_view{name_pool_}.substr(instruction.name_offset, instruction.name_size);
+    }
+
+    // Linear probing; the table is at least half empty, so probe sequences stay short.
+    const Instruction *find(std::string_view key, std::uint64_t hash) const noexcept
+    {
+        for (std::size_t position = hash & (table_.size() - 1); table_[position]; position = (position + 1) & (table_.size() - 1))
+        {
+            const Instruction &instruction = instructions_[table_[position] - 1];
+            if (instruction.hash == hash && name(instruction) == key)
+            {
+                return &instruction;
+            }
+        }
+        return nullptr;
+    }
+
+    static bool convert(SchemaType type, const JsonValue &json_value, SchemaValue &slot) noexcept
+    {
+        switch (type)
+        {
+        case SchemaType::number:
+            if (const auto *number = std::get_if<JsonNumber>(&json_value.value))
+            {
+                slot = *number;
+                return true;
+            }
+            return false;
+        case SchemaType::integer:
+            if (const auto *number = std::get_if<JsonNumber>(&json_value.value);
+                number && std::trunc(*number) == *number
+                && *number >= static_cast<JsonNumber>(std::numeric_limits<std::int64_t>::min())
+                && *number < -static_cast<JsonNumber>(std::numeric_limits<std::int64_t>::min()))
+            {
+                slot = static_cast<std::int64_t>(*number);
+                return true;
+            }
+            return false;
+        case SchemaType::string:
+            if (const auto *string = std::get_if<JsonString>(&json_value.value))
+            {
+                slot = std::string_view{*string};
+                return true;
+            }
+            return false;
+        case SchemaType::list:
+            if (const auto *list = std::get_if<JsonList>(&json_value.value))
+            {
+                slot = list;
+                return true;
+            }
+            return false;
+        case SchemaType::object:
+            if (const auto *object = std::get_if<JsonObject>(&json_value.value))
+            {
+                slot = object;
+                return true;
+            }
+            return false;
+        case SchemaType::any:
+            slot = &json_value;
+            return true;
+        }
+        return false;
+    }
+
+    std::string class_name_;
+    std::string name_pool_;
+    std::vector<Instruction> instructions_;
+    // Instruction index + 1 per bucket, 0 for an empty bucket.
+    std::vector<std::uint32_t> table_;
+    std::size_t required_count_ = 0;
+};
+
+} // namespace json
@@ -0,0 +1,415 @@
+#pragma once
+
+#include "json.hpp"
+
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <variant>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace json
+{
+
+// Front end for the text of JSON strings: UTF-8 validation and escape decoding. The scans look at
+// 16 bytes per step with SSE2 (part of every x86-64 target) and fall back to a byte loop elsewhere.
+
+namespace detail
+{
+
+// First position at or after position holding '"', '\\', a control character or a non-ASCII byte;
+// text.size() if there is none. Everything before it can be taken over unchanged.
+inline std::size_t find_string_special(std::string_view text, std::size_t position) noexcept
+{
+#if defined(__SSE2__)
+    const __m128i quote = _mm_set1_epi8('"');
+    const __m128i backslash = _mm_set1_epi8('\\');
+    const __m128i control_limit = _mm_set1_epi8(0x20);
+    for (; position + 16 <= text.size(); position += 16)
+    {
+        const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i *>(text.data() + position));
+        // The compare is signed, so bytes >= 0x80 are negative and count as below 0x20 too.
+        const __m128i special = _mm_or_si128(
+                _mm_or_si128(_mm_cmpeq_epi8(chunk, quote), _mm_cmpeq_epi8(chunk, backslash)),
+                _mm_cmplt_epi8(chunk, control_limit));
+        if (const int mask = _mm_movemask_epi8(special))
+        {
+            return position + static_cast<std::size_t>(std::countr_zero(static_cast<unsigned>(mask)));
+        }
+    }
+#endif
+    for (; position < text.size(); ++position)
+    {
+        const auto byte = static_cast<unsigned char>(text[position]);
+        if (byte == '"' || byte == '\\' || byte < 0x20 || byte >= 0x80)
+        {
+            return position;
+        }
+    }
+    return position;
+}
+
+// First non-ASCII byte at or after position, text.size() if there is none.
+inline std::size_t find_non_ascii(std::string_view text, std::size_t position) noexcept
+{
+#if defined(__SSE2__)
+    for (; position + 16 <= text.size(); position += 16)
+    {
+        const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i *>(text.data() + position));
+        if (const int mask = _mm_movemask_epi8(chunk))
+        {
+            return position + static_cast<std::size_t>(std::countr_zero(static_cast<unsigned>(mask)));
+        }
+    }
+#endif
+    for (; position < text.size(); ++position)
+    {
+        if (static_cast<unsigned char>(text[position]) >= 0x80)
+        {
+            return position;
+        }
+    }
+    return position;
+}
+
+// Length of the well-formed UTF-8 sequence starting at a non-ASCII byte, 0 if it is ill-formed
+// (Unicode table 3-7: no overlong forms, no surrogates, nothing above U+10FFFF).
+constexpr std::size_t utf8_sequence_size(std::string_view text, std::size_t position) noexcept
+{
+    const auto byte = [&text] (std::size_t idx) {
+        return idx < text.size() ? static_cast<unsigned char>(text[idx]) : 0u;
+    };
+    const unsigned lead = byte(position);
+    const unsigned second = byte(position + 1);
+    const auto continuation = [] (unsigned value) {
+        return (value & 0xc0) == 0x80;
+    };
+    if (lead >= 0xc2 && lead <= 0xdf)
+    {
+        return continuation(second) ? 2 : 0;
+    }
+    if (lead >= 0xe0 && lead <= 0xef)
+    {
+        const unsigned low = lead == 0xe0 ? 0xa0 : 0x80;
+        const unsigned high = lead == 0xed ? 0x9f : 0xbf;
+        return second >= low && second <= high && continuation(byte(position + 2)) ? 3 : 0;
+    }
+    if (lead >= 0xf0 && lead <= 0xf4)
+    {
+        const unsigned low = lead == 0xf0 ? 0x90 : 0x80;
+        const unsigned high = lead == 0xf4 ? 0x8f : 0xbf;
+        return second >= low && second <= high && continuation(byte(position + 2)) && continuation(byte(position + 3)) ? 4 : 0;
+    }
+    return 0;
+}
+
+// Writes code_point as 1 to 4 bytes at output and advances it.
+constexpr void write_utf8(char *&output, std::uint32_t code_point) noexcept
+{
+    if (code_point < 0x80)
+    {
+        *output++ = static_cast<char>(code_point);
+    }
+    else if (code_point < 0x800)
+    {
+        *output++ = static_cast<char>(0xc0 | (code_point >> 6));
+        *output++ = static_cast<char>(0x80 | (code_point & 0x3f));
+    }
+    else if (code_point < 0x10000)
+    {
+        *output++ = static_cast<char>(0xe0 | (code_point >> 12));
+        *output++ = static_cast<char>(0x80 | ((code_point >> 6) & 0x3f));
+        *output++ = static_cast<char>(0x80 | (code_point & 0x3f));
+    }
+    else
+    {
+        *output++ = static_cast<char>(0xf0 | (code_point >> 18));
+        *output++ = static_cast<char>(0x80 | ((code_point >> 12) & 0x3f));
+        *output++ = static_cast<char>(0x80 | ((code_point >> 6) & 0x3f));
+        *output++ = static_cast<char>(0x80 | (code_point & 0x3f));
+    }
+}
+
+// Value of the 4 hex digits at position, or -1.
+constexpr std::int32_t parse_hex4(std::string_view text, std::size_t position) noexcept
+{
+    if (position + 4 > text.size())
+    {
+        return -1;
+    }
+    std::int32_t value = 0;
+    for (std::size_t idx = position; idx < position + 4; ++idx)
+    {
+        const char digit = text[idx];
+        value <<= 4;
+        if (digit >= '0' && digit <= '9') value |= digit - '0';
+        else if (digit >= 'a' && digit <= 'f') value |= digit - 'a' + 10;
+        else if (digit >= 'A' && digit <= 'F') value |= digit - 'A' + 10;
+        else return -1;
+    }
+    return value;
+}
+
+// What the escape "\\x" stands for, per byte x; 0 for 'u' and for invalid escapes.
+inline constexpr std::array<char, 256> simple_escapes = [] {
+    std::array<char, 256> table{};
+    table['"'] = '"';
+    table['\\'] = '\\';
+    table['/'] = '/';
+    table['b'] = '\b';
+    table['f'] = '\f';
+    table['n'] = '\n';
+    table['r'] = '\r';
+    table['t'] = '\t';
+    return table;
+}();
+
+// Decodes the escape starting at the backslash at position, writes it at output and advances
+// output. An escape never decodes to more bytes than it takes, so output can share a buffer sized
+// for the input. Returns the position after the escape, or 0 for an invalid escape (a string
+// cannot start with one).
+constexpr std::size_t decode_escape(std::string_view text, std::size_t position, char *&output) noexcept
+{
+    const char kind = position + 1 < text.size() ? text[position + 1] : '\0';
+    if (const char simple = simple_escapes[static_cast<unsigned char>(kind)])
+    {
+        *output++ = simple;
+        return position + 2;
+    }
+    if (kind != 'u')
+    {
+        return 0;
+    }
+    const std::int32_t high = parse_hex4(text, position + 2);
+    if (high < 0)
+    {
+        return 0;
+    }
+    if (high < 0xd800 || high > 0xdfff)
+    {
+        write_utf8(output, static_cast<std::uint32_t>(high));
+        return position + 6;
+    }
+    // A high surrogate must be followed by an escaped low surrogate.
+    if (high > 0xdbff || position + 8 > text.size() || text[position + 6] != '\\' || text[position + 7] != 'u')
+    {
+        return 0;
+    }
+    const std::int32_t low = parse_hex4(text, position + 8);
+    if (low < 0xdc00 || low > 0xdfff)
+    {
+        return 0;
+    }
+    write_utf8(output, 0x10000 + ((static_cast<std::uint32_t>(high) - 0xd800) << 10) + (static_cast<std::uint32_t>(low) - 0xdc00));
+    return position + 12;
+}
+
+// decode_escape appending to output.
+constexpr std::size_t decode_escape(std::string_view text, std::size_t position, std::string &output)
+{
+    char buffer[4]{};
+    char *end = buffer;
+    const std::size_t next = decode_escape(text, position, end);
+    output.append(buffer, end);
+    return next;
+}
+
+inline Parser<std::string_view> string_error(const char *what, std::size_t position)
+{
+    return Parser<std::string_view>{ParseError{error_string(what, " at byte ", std::to_string(position))}};
+}
+
+} // namespace detail
+
+// Length of the longest well-formed UTF-8 prefix of text; equal to text.size() for valid UTF-8.
+inline std::size_t valid_utf8_prefix(std::string_view text) noexcept
+{
+    for (std::size_t position = detail::find_non_ascii(text, 0); position < text.size();
+         position = detail::find_non_ascii(text, position))
+    {
+        const std::size_t size = detail::utf8_sequence_size(text, position);
+        if (size == 0)
+        {
+            return position;
+        }
+        position += size;
+    }
+    return text.size();
+}
+
+inline bool is_valid_utf8(std::string_view text) noexcept
+{
+    return valid_utf8_prefix(text) == text.size();
+}
+
+namespace detail
+{
+
+// Bit i set when text[position + i] is '"', '\\', a control character or non-ASCII, for the 16
+// bytes at position.
+#if defined(__SSE2__)
+inline unsigned string_special_mask(std::string_view text, std::size_t position) noexcept
+{
+    const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i *>(text.data() + position));
+    const __m128i special = _mm_or_si128(
+            _mm_or_si128(_mm_cmpeq_epi8(chunk, _mm_set1_epi8('"')), _mm_cmpeq_epi8(chunk, _mm_set1_epi8('\\'))),
+            _mm_cmplt_epi8(chunk, _mm_set1_epi8(0x20)));
+    return static_cast<unsigned>(_mm_movemask_epi8(special));
+}
+#endif
+
+// Handles the special byte at position: validates a UTF-8 sequence and copies it, or decodes an
+// escape. Returns the position after it, or sets error and returns 0.
+inline std::size_t decode_special(std::string_view raw, std::size_t position, char *&output, const char *&error) noexcept
+{
+    const auto byte = static_cast<unsigned char>(raw[position]);
+    if (byte >= 0x80)
+    {
+        const std::size_t size = utf8_sequence_size(raw, position);
+        if (size == 0)
+        {
+            error = "Invalid UTF-8 in JSON string";
+            return 0;
+        }
+        std::memcpy(output, raw.data() + position, size);
+        output += size;
+        return position + size;
+    }
+    if (byte != '\\')
+    {
+        error = byte == '"' ? "Unescaped '\"' in JSON string" : "Unescaped control character in JSON string";
+        return 0;
+    }
+    const std::size_t next = decode_escape(raw, position, output);
+    if (next == 0)
+    {
+        error = "Invalid escape in JSON string";
+    }
+    return next;
+}
+
+// decode_string from the first escape at position on. The output is written through a pointer
+// into storage sized for the input, and the specials of each 16-byte chunk come from one mask:
+// chunks without any are copied whole, and the runs between the escapes of a chunk are copied
+// in one piece each instead of scanning again after every escape.
+inline Parser<std::string_view> decode_escaped(std::string_view raw, std::size_t position, std::string &storage)
+{
+    storage.resize(raw.size());
+    char *const begin = storage.data();
+    std::memcpy(begin, raw.data(), position);
+    char *output = begin + position;
+    const char *error = nullptr;
+#if defined(__SSE2__)
+    // The output never runs ahead of the input, so a chunk copied to output stays in storage.
+    while (position + 16 <= raw.size())
+    {
+        const std::size_t chunk = position;
+        unsigned mask = string_special_mask(raw, chunk);
+        if (mask == 0)
+        {
+            std::memcpy(output, raw.data() + chunk, 16);
+            output += 16;
+            position += 16;
+            continue;
+        }
+        // Specials of this chunk in order; a special that ends past the next one (an escape or
+        // UTF-8 sequence running over it) drops the bits it covered.
+        while (mask)
+        {
+            const std::size_t special = chunk + static_cast<std::size_t>(std::countr_zero(mask));
+            std::memcpy(output, raw.data() + position, special - position);
+            output += special - position;
+            // Short escapes, the common case, are decoded here without the call.
+            const char simple = raw[special] == '\\' && special + 1 < raw.size() ? simple_escapes[static_cast<unsigned char>(raw[special + 1])] : '\0';
+            if (simple)
+            {
+                *output++ = simple;
+                position = special + 2;
+            }
+            else if ((position = decode_special(raw, special, output, error)) == 0)
+            {
+                return string_error(error, special);
+            }
+            const std::size_t consumed = position - chunk;
+            mask = consumed >= 16 ? 0 : mask & (~0u << consumed);
+        }
+        if (position < chunk + 16)
+        {
+            std::memcpy(output, raw.data() + position, chunk + 16 - position);
+            output += chunk + 16 - position;
+            position = chunk + 16;
+        }
+    }
+#endif
+    while (position < raw.size())
+    {
+        const std::size_t special = find_string_special(raw, position);
+        std::memcpy(output, raw.data() + position, special - position);
+        output += special - position;
+        if (special == raw.size())
+        {
+            break;
+        }
+        position = decode_special(raw, special, output, error);
+        if (position == 0)
+        {
+            return string_error(error, special);
+        }
+    }
+    storage.resize(static_cast<std::size_t>(output - begin));
+    return Parser<std::string_view>{std::string_view{storage}};
+}
+
+} // namespace detail
+
+// Decodes the text between the quotes of a JSON string literal: validates UTF-8, rejects raw
+// quotes and control characters, and resolves escapes. Without escapes the result borrows raw;
+// otherwise it is decoded into storage, which the result then refers to. Reusing storage across
+// calls keeps its capacity, so decoding does not allocate once it is large enough.
+inline Parser<std::string_view> decode_string(std::string_view raw, std::string &storage)
+{
+    std::size_t position = 0;
+    while ((position = detail::find_string_special(raw, position)) < raw.size())
+    {
+        const auto byte = static_cast<unsigned char>(raw[position]);
+        if (byte == '\\')
+        {
+            return detail::decode_escaped(raw, position, storage);
+        }
+        if (byte < 0x80)
+        {
+            return detail::string_error(byte == '"' ? "Unescaped '\"' in JSON string" : "Unescaped control character in JSON string", position);
+        }
+        const std::size_t size = detail::utf8_sequence_size(raw, position);
+        if (size == 0)
+        {
+            return detail::string_error("Invalid UTF-8 in JSON string", position);
+        }
+        position += size;
+    }
+    return Parser<std::string_view>{raw};
+}
+
+// The JsonString of json_value checked to be valid UTF-8, borrowed from json_value.
+inline Parser<std::string_view> parse_utf8_string(const JsonValue &json_value)
+{
+    const auto *json_string = std::get_if<JsonString>(&json_value.value);
+    if (!json_string)
+    {
+        return Parser<std::string_view>{ParseError{"Expected JSON string"}};
+    }
+    if (const std::size_t valid = valid_utf8_prefix(*json_string); valid != json_string->size())
+    {
+        return detail::string_error("Invalid UTF-8 in JSON string", valid);
+    }
+    return Parser<std::string_view>{std::string_view{*json_string}};
+}
+
+} // namespace json
@@ -0,0 +1,260 @@
+#pragma once
+
+#include "functional_applicative.hpp"
+#include "json.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <memory_resource>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <variant>
+#include <vector>
+
+namespace json
+{
+
+enum class ValidationCode : std::uint8_t
+{
+    missing_field,
+    expected_object,
+    expected_string,
+    expected_number,
+    expected_list,
+    invalid_value,
+};
+
+// Location inside a document. Validators keep the chain on the stack while descending; it is only
+// copied into the arena when an error is recorded. Field names must outlive rendering.
+struct ValidationPath final
+{
+    const ValidationPath *parent = nullptr;
+    std::string_view field;
+    std::size_t index = 0;
+};
+
+// Immutable rope of errors: a leaf holds one (path, code) entry, an inner node concatenates two
+// ropes, so accumulating errors in fapply is O(1) and never touches strings.
+struct ValidationErrors final
+{
+    const ValidationErrors *lhs = nullptr;
+    const ValidationErrors *rhs = nullptr;
+    const ValidationPath *path = nullptr;
+    ValidationCode code = ValidationCode::invalid_value;
+    std::size_t count = 1;
+};
+
+// Per-document storage for errors and their paths. The arena owns its first buffer, so reset()
+// rewinds into it without touching the heap; only documents that outgrow it allocate more.
+class ValidationArena final
+{
+public:
+    explicit ValidationArena(std::size_t initial_bytes = 4096)
+        : buffer_(std::make_unique<std::byte[]>(std::max<std::size_t>(initial_bytes, 1)))
+        , resource_(buffer_.get(), std::max<std::size_t>(initial_bytes, 1))
+    {
+    }
+
+    ValidationArena(const ValidationArena &) = delete;
+    ValidationArena &operator=(const ValidationArena &) = delete;
+
+    const ValidationErrors *error(const ValidationPath *path, ValidationCode code)
+    {
+        return create<ValidationErrors>(nullptr, nullptr, persist(path), code, std::size_t{1});
+    }
+
+    const ValidationErrors *concat(const ValidationErrors *lhs, const ValidationErrors *rhs)
+    {
+        return create<ValidationErrors>(lhs, rhs, nullptr, ValidationCode::invalid_value, lhs->count + rhs->count);
+    }
+
+    void reset() noexcept
+    {
+        resource_.release();
+    }
+
+private:
+    template<typename T, typename ...Args>
+    const T *create(Args &&...args)
+    {
+        void *storage = resource_.allocate(sizeof(T), alignof(T));
+        return ::new (storage) T{std::forward<Args>(args)...};
+    }
+
+    const ValidationPath *persist(const ValidationPath *path)
+    {
+        if (!path)
+        {
+            return nullptr;
+        }
+        return create<ValidationPath>(persist(path->parent), path->field, path->index);
+    }
+
+    std::unique_ptr<std::byte[]> buffer_;
+    std::pmr::monotonic_buffer_resource resource_;
+};
+
+struct ValidationFailure final
+{
+    ValidationArena *arena;
+    const ValidationErrors *errors;
+};
+
+// Applicative (deliberately not a Monad) that keeps going after a failure and collects every error.
+template<typename T>
+struct Validation final
+{
+    std::variant<T, ValidationFailure> value;
+};
+
+template<typename T>
+Validation<T> validation_error(ValidationArena &arena, const ValidationPath *path, ValidationCode code)
+{
+    return Validation<T>{ValidationFailure{&arena, arena.error(path, code)}};
+}
+
+template<typename FieldType>
+Validation<FieldType> validate_field(ValidationArena &arena, const JsonObject &object, std::string_view field_name, const ValidationPath *parent = nullptr)
+{
+    const ValidationPath path{parent, field_name};
+    const auto found_element = std::find_if(begin(object), end(object), [field_name] (const auto &field) {
+                                                return field.first == field_name;
+                                            });
+    if (found_element == end(object))
+    {
+        return validation_error<FieldType>(arena, &path, ValidationCode::missing_field);
+    }
+    if (const auto *value = std::get_if<FieldType>(&found_element->second.value))
+    {
+        return Validation<FieldType>{*value};
+    }
+    constexpr auto code = std::is_same_v<FieldType, JsonObject> ? ValidationCode::expected_object
+        : std::is_same_v<FieldType, JsonString> ? ValidationCode::expected_string
+        : std::is_same_v<FieldType, JsonNumber> ? ValidationCode::expected_number
+        : ValidationCode::expected_list;
+    return validation_error<FieldType>(arena, &path, code);
+}
+
+inline std::string_view to_string(ValidationCode code) noexcept
+{
+    switch (code)
+    {
+    case ValidationCode::missing_field: return "missing field";
+    case ValidationCode::expected_object: return "expected JSON object";
+    case ValidationCode::expected_string: return "expected JSON string";
+    case ValidationCode::expected_number: return "expected JSON number";
+    case ValidationCode::expected_list: return "expected JSON list";
+    case ValidationCode::invalid_value: return "invalid value";
+    }
+    return "unknown error";
+}
+
+inline std::string render_path(const ValidationPath *path)
+{
+    std::vector<const ValidationPath *> segments;
+    for (; path; path = path->parent)
+    {
+        segments.push_back(path);
+    }
+    std::string result;
+    for (auto it = segments.rbegin(); it != segments.rend(); ++it)
+    {
+        result += '/';
+        result += (*it)->field.empty() ? std::to_string((*it)->index) : std::string((*it)->field);
+    }
+    return result.empty() ? "/" : result;
+}
+
+// Formats the collected errors in document order, one "path: message" line each.
+inline std::vector<std::string> render_errors(const ValidationFailure &failure)
+{
+    std::vector<std::string> lines;
+    lines.reserve(failure.errors->count);
+    std::vector<const ValidationErrors *> pending{failure.errors};
+    while (!pending.empty())
+    {
+        const auto *node = pending.back();
+        pending.pop_back();
+        if (node->lhs)
+        {
+            pending.push_back(node->rhs);
+            pending.push_back(node->lhs);
+            continue;
+        }
+        lines.push_back(render_path(node->path) + ": " + std::string(to_string(node->code)));
+    }
+    return lines;
+}
+
+} // namespace json
+
+namespace functional
+{
+
+template<>
+struct FunctionalTraits<json::Validation> final
+{
+    template<typename Func, typename Input>
+    static constexpr auto map(Func &&func, json::Validation<Input> &&input)
+    {
+        using FuncRet = std::remove_cvref_t<std::invoke_result_t<Func &&, Input &&>>;
+        if (auto *failure = std::get_if<json::ValidationFailure>(&input.value))
+        {
+            return json::Validation<FuncRet>{*failure};
+        }
+        return json::Validation<FuncRet>{std::invoke(std::forward<Func>(func), std::get<0>(std::move(input.value)))};
+    }
+
+    template<typename Func, typename Input>
+    static constexpr auto map(Func &&func, const json::Validation<Input> &input)
+    {
+        using FuncRet = std::remove_cvref_t<std::invoke_result_t<Func &&, const Input &>>;
+        if (auto *failure = std::get_if<json::ValidationFailure>(&input.value))
+        {
+            return json::Validation<FuncRet>{*failure};
+        }
+        return json::Validation<FuncRet>{std::invoke(std::forward<Func>(func), std::get<0>(input.value))};
+    }
+
+    // Unlike json::Parser both sides are always inspected, and two failures are concatenated.
+    template<typename Func, typename Input>
+        requires is_instance_v<json::Validation, Input>
+    static constexpr auto apply(json::Validation<Func> &&func, Input &&input)
+    {
+        return apply_impl(std::move(func), std::forward<Input>(input));
+    }
+
+    template<typename Func, typename Input>
+        requires is_instance_v<json::Validation, Input>
+    static constexpr auto apply(const json::Validation<Func> &func, Input &&input)
+    {
+        return apply_impl(func, std::forward<Input>(input));
+    }
+
+private:
+    template<typename FuncValidation, typename Input>
+    static constexpr auto apply_impl(FuncValidation &&func, Input &&input)
+    {
+        using FuncRet = std::remove_cvref_t<decltype(map(std::get<0>(std::forward<FuncValidation>(func).value), std::forward<Input>(input)))>;
+        const auto *func_failure = std::get_if<json::ValidationFailure>(&func.value);
+        const auto *input_failure = std::get_if<json::ValidationFailure>(&input.value);
+        if (func_failure && input_failure)
+        {
+            return FuncRet{json::ValidationFailure{
+                func_failure->arena,
+                func_failure->arena->concat(func_failure->errors, input_failure->errors),
+            }};
+        }
+        if (func_failure)
+        {
+            return FuncRet{*func_failure};
+        }
+        return map(std::get<0>(std::forward<FuncValidation>(func).value), std::forward<Input>(input));
+    }
+};
+
+} // namespace functional
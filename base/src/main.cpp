@@ -5,8 +5,31 @@
 #include "functional_partially_applicable.hpp"
 #include "functional_monad.hpp"
 #include "functional_optional.hpp"
+#include "functional_compact_optional.hpp"
+#include "functional_vector.hpp"
+#include "functional_ranges.hpp"
+#include "functional_reader.hpp"
+#include "functional_state.hpp"
+#include "functional_unique_function.hpp"
+#include "functional_task.hpp"
+#include "functional_traverse.hpp"
+#include "functional_foldable.hpp"
+#include "functional_stream.hpp"
+#include "functional_text_parser.hpp"
 #include "functional_alternative.hpp"
 #include "json.hpp"
+#include "json_validation.hpp"
+#include "json_fields.hpp"
+#include "json_schema.hpp"
+#include "json_enum.hpp"
+#include "json_cache.hpp"
+#include "json_persistent.hpp"
+#include "json_constant.hpp"
+#include "json_path.hpp"
+#include "json_string.hpp"
+#include "json_context.hpp"
+#include "json_instrumentation.hpp"
+#include "test_functional.hpp"
 
 #include <functional>
 #include <type_traits>
@@ -16,119 +39,52 @@
 #include <vector>
 #include <ranges>
 #include <concepts>
+#include <numeric>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <atomic>
+#include <charconv>
+#include <cmath>
+#include <limits>
+#include <array>
+#include <memory>
 
 inline namespace
 {
 
-namespace test_functional
-{
-
-template<typename T>
-struct MyMonad final {
-    T value;
-};
-
-template<typename Func, typename T>
-#define CALL_TEXT std::forward<Func>(func)(std::move(value.value))
-constexpr auto fmap(Func &&func, MyMonad<T> &&value) noexcept(noexcept(CALL_TEXT)) {
-    using functional::fpure;
-    return fpure<MyMonad>(CALL_TEXT);
-#undef CALL_TEXT
-}
-
-template<typename Func, typename T>
-#define CALL_TEXT std::forward<Func>(func)(value.value)
-constexpr auto fmap(Func &&func, const MyMonad<T> &value) noexcept(noexcept(CALL_TEXT)) {
-    using functional::fpure;
-    return fpure<MyMonad>(CALL_TEXT);
-#undef CALL_TEXT
-}
-
-template<typename Func, typename T>
-    requires functional::is_instance_v<MyMonad, T>
-#define CALL_TEXT fmap(std::move(func.value), std::forward<T>(value))
-constexpr auto fapply(MyMonad<Func> &&func, T &&value) noexcept(noexcept(CALL_TEXT)) {
-    return CALL_TEXT;
-#undef CALL_TEXT
-}
-
-template<typename Func, typename T>
-    requires functional::is_instance_v<MyMonad, T>
-#define CALL_TEXT fmap(func.value, std::forward<T>(value))
-constexpr auto fapply(const MyMonad<Func> &func, T &&value) noexcept(noexcept(CALL_TEXT)) {
-    return CALL_TEXT;
-#undef CALL_TEXT
-}
-
-template<typename T>
-    requires functional::is_instance_v<MyMonad, T>
-auto fjoin(MyMonad<T> &&value) {
-    return std::move(value.value);
-}
-
-template<typename T>
-    requires functional::is_instance_v<MyMonad, T>
-auto fjoin(const MyMonad<T> &value) {
-    return value.value;
-}
-
 template<typename T>
-    requires requires(T t, std::ostream &stream) {
-        { stream << t };
+static std::ostream &operator<<(std::ostream &stream, const std::vector<T> &value)
+{
+    stream << "std::vector{";
+    for (std::size_t idx = 0; idx < value.size(); ++idx) {
+        stream << (idx == 0 ? "" : ", ") << value[idx];
     }
-std::ostream &operator<<(std::ostream &stream, const MyMonad<T> &value) {
-    return stream << "MyMonad{" << value.value << "}";
+    return stream << "}";
 }
 
 template<typename T>
-struct MyMonadMethods final {
-    T value;
-
-    template<typename Func>
-    constexpr auto map(Func &&func) const &
-    {
-        return MyMonadMethods<decltype(std::forward<Func>(func)(value))>{std::forward<Func>(func)(value)};
-    }
-
-    template<typename Func>
-    constexpr auto map(Func &&func) &&
-    {
-        return MyMonadMethods<decltype(std::forward<Func>(func)(std::move(value)))>{std::forward<Func>(func)(std::move(value))};
-    }
-
-    template<typename Func>
-    constexpr auto apply(const MyMonadMethods<Func> &func) const &
-    {
-        return MyMonadMethods<decltype(func.value(value))>{func.value(value)};
-    }
-
-    template<typename Func>
-    constexpr auto apply(const MyMonadMethods<Func> &func) &&
-    {
-        return MyMonadMethods<decltype(func.value(std::move(value)))>{func.value(std::move(value))};
-    }
-
-    constexpr auto join() const &
-    {
-        return value;
-    }
-
-    constexpr auto join() &&
-    {
-        return std::move(value);
+static std::ostream &operator<<(std::ostream &stream, const std::optional<T> &value)
+{
+    if (value) {
+        stream << "std::optional{" << *value << "}";
+    } else {
+        stream << "std::nullopt";
     }
-};
+    return stream;
+}
 
-template<typename T>
-    requires requires(T t, std::ostream &stream) {
-        { stream << t };
+template<typename T, typename Niche>
+static std::ostream &operator<<(std::ostream &stream, const functional::CompactOptional<T, Niche> &value)
+{
+    if (value) {
+        stream << "functional::CompactOptional{" << *value << "}";
+    } else {
+        stream << "functional::CompactOptional{}";
     }
-std::ostream &operator<<(std::ostream &stream, const MyMonadMethods<T> &value) {
-    return stream << "MyMonadMethods{" << value.value << "}";
+    return stream;
 }
 
-} // namespace test_functional
-
 template<typename T>
 concept Printable = requires(T val, std::ostream &stream) {
     { stream << val };
@@ -203,17 +159,6 @@ struct OptionalResult final
     }
 };
 
-template<typename T>
-static std::ostream &operator<<(std::ostream &stream, const std::optional<T> &value)
-{
-    if (value) {
-        stream << "std::optional{" << *value << "}";
-    } else {
-        stream << "std::nullopt";
-    }
-    return stream;
-}
-
 static void optional_test()
 {
     std::cout << __PRETTY_FUNCTION__ << '\n';
@@ -244,6 +189,401 @@ static void optional_test()
     std::cout << '\n';
 }
 
+static void compact_optional_test()
+{
+    std::cout << __PRETTY_FUNCTION__ << '\n';
+    using functional::CompactOptional;
+    using functional::fmap;
+    using functional::operator>>;
+    using functional::operator|;
+    static_assert(sizeof(CompactOptional<double>) == sizeof(double));
+    static_assert(sizeof(CompactOptional<const int *, functional::NullNiche>) == sizeof(const int *));
+    static_assert(sizeof(CompactOptional<const int *>) > sizeof(const int *), "null is a value unless NullNiche is picked");
+    static_assert(sizeof(CompactOptional<int, functional::SentinelNiche<-1>>) == sizeof(int));
+    static_assert(functional::Foldable<CompactOptional>);
+
+    constexpr auto checked_sqrt = [] (double value) {
+        return value < 0 ? CompactOptional<double>{} : CompactOptional<double>{std::sqrt(value)};
+    };
+    std::cout << "sqrt chain: " << (CompactOptional<double>{16.0} >> checked_sqrt >> checked_sqrt) << '\n';
+    std::cout << "sqrt chain (negative): " << (CompactOptional<double>{-16.0} >> checked_sqrt | CompactOptional<double>{0.0}) << '\n';
+    const auto computed_nan = fmap([] (double value) { return value * std::numeric_limits<double>::quiet_NaN(); }, CompactOptional<double>{1.0});
+    std::cout << "computed NaN is a value: " << computed_nan.has_value() << '\n';
+
+    const int answer = 42;
+    std::cout << "pointer: " << fmap([] (const int *value) { return *value; }, CompactOptional<const int *>{&answer}) << '\n';
+    const CompactOptional<int, functional::SentinelNiche<-1>> row_index;
+    std::cout << "sentinel: " << row_index.value_or(0) << '\n';
+    std::cout << "null pointer is a value: " << CompactOptional<const int *>{nullptr}.has_value() << '\n';
+    try
+    {
+        CompactOptional<int, functional::SentinelNiche<-1>>{-1};
+    }
+    catch (const std::invalid_argument &error)
+    {
+        std::cout << "sentinel value: " << error.what() << '\n';
+    }
+    std::cout << '\n';
+}
+
+static void noexcept_test()
+{
+    std::cout << __PRETTY_FUNCTION__ << '\n';
+    using functional::fmap;
+    using functional::fpure;
+    using functional::fjoin;
+    using functional::fbind;
+    using functional::falternate;
+    using functional::operator*;
+    using functional::operator>>;
+    using functional::operator|;
+    constexpr auto safe = [] (int value) noexcept { return value * 2; };
+    constexpr auto throwing = [] (int value) { return value * 2; };
+    constexpr auto safe_bind = [] (int value) noexcept { return std::optional<int>{value}; };
+    constexpr auto throwing_bind = [] (int value) { return std::optional<int>{value}; };
+    std::optional<int> value{1};
+    const std::optional<std::optional<std::string>> nested_strings;
+    const std::optional<std::string> fallback;
+
+    static_assert(noexcept(fpure<std::optional>(1)));
+    static_assert(noexcept(fmap(safe, std::optional<int>{1})));
+    static_assert(noexcept(fmap(safe, value)));
+    static_assert(!noexcept(fmap(throwing, std::optional<int>{1})));
+    static_assert(!noexcept(fmap(throwing, value)));
+    static_assert(noexcept(std::optional{safe} * std::optional<int>{1}));
+    static_assert(!noexcept(std::optional{throwing} * std::optional<int>{1}));
+    static_assert(noexcept(fjoin(std::optional<std::optional<int>>{1})));
+    static_assert(!noexcept(fjoin(std::as_const(nested_strings))));
+    static_assert(noexcept(fbind(safe_bind, value)));
+    static_assert(noexcept(std::optional<int>{1} >> safe_bind));
+    static_assert(!noexcept(std::optional<int>{1} >> throwing_bind));
+    static_assert(noexcept(falternate(std::optional<int>{}, value)));
+    static_assert(noexcept(std::optional<int>{} | std::optional<int>{1}));
+    static_assert(noexcept(std::optional<std::string>{} | std::optional<std::string>{}));
+    static_assert(!noexcept(std::optional<std::string>{} | fallback));
+
+    static_assert(noexcept(fmap(safe, functional::CompactOptional<int>{1})));
+    static_assert(!noexcept(fmap(throwing, functional::CompactOptional<int>{1})));
+    static_assert(noexcept(functional::CompactOptional<int>{1} >> [] (int v) noexcept { return functional::CompactOptional<int>{v}; }));
+    static_assert(std::is_nothrow_move_constructible_v<functional::CompactOptional<std::string>>);
+
+    static_assert(noexcept(fmap(safe, test_functional::MyMonadMethods<int>{1})) == noexcept(test_functional::MyMonadMethods<int>{1}.map(safe)));
+    std::cout << "noexcept is propagated\n";
+    std::cout << '\n';
+}
+
+static void vector_test()
+{
+    std::cout << __PRETTY_FUNCTION__ << '\n';
+    using functional::fmap;
+    using functional::operator*;
+    using functional::partially_applicable;
+    {
+        const auto result =
+            fmap(partially_applicable([] (int a, int b) { return a * 10 + b; }),
+                 std::vector{1, 2})
+            * std::vector{3, 4};
+        std::cout << "cartesian apply: " << result << '\n';
+    }
+    {
+        std::vector<int> input(functional::vector_parallel_threshold * 2);
+        std::iota(input.begin(), input.end(), 0);
+        const auto *const buffer = input.data();
+        const auto result = fmap([] (int value) { return value * 2; }, std::move(input));
+        std::cout << "in-place reuse: " << (result.data() == buffer) << ", last: " << result.back() << '\n';
+        // Parallelism is opt-in: fmap_par runs on the pool, plain fmap stays sequential at any size.
+        const auto halved = functional::fmap_par([] (int value) { return value * 0.5; }, result);
+        std::cout << "parallel map: " << halved.size() << " elements, last: " << halved.back() << '\n';
+        std::size_t calls = 0;
+        static_cast<void>(fmap([&calls] (int value) { ++calls; return value + 1; }, result));
+        std::cout << "sequential map with side effects: " << calls << " calls\n";
+    }
+    std::cout << '\n';
+}
+
+static void lazy_range_test()
+{
+    std::cout << __PRETTY_FUNCTION__ << '\n';
+    using functional::fmap;
+    using functional::fpure;
+    using functional::lazy;
+    using functional::materialize;
+    using functional::operator*;
+    using functional::operator>>;
+    const auto squares = fmap([] (int value) { return value * value; }, lazy(std::views::iota(1, 6)));
+    std::cout << "map: " << materialize(squares) << '\n';
+    const auto expanded = lazy(std::views::iota(1, 4))
+            >> [] (int value) { return lazy(std::views::iota(0, value)); };
+    std::cout << "bind: " << materialize(expanded) << '\n';
+    const auto applied = fpure<functional::LazyRange>([] (int value) { return value + 100; }) * squares;
+    std::cout << "apply: " << materialize(applied) << '\n';
+    std::size_t checksum = 0;
+    for (const auto value : fmap([] (std::size_t value) { return value % 7; }, lazy(std::views::iota(std::size_t{0}, std::size_t{1} << 20)))) {
+        checksum += value;
+    }
+    std::cout << "streamed checksum: " << checksum << '\n';
+    std::cout << '\n';
+}
+
+struct Config final
+{
+    int base;
+    int factor;
+};
+
+static void reader_state_test()
+{
+    std::cout << __PRETTY_FUNCTION__ << '\n';
+    using functional::fmap;
+    using functional::fpure;
+    using functional::asks;
+    using functional::local;
+    using functional::operator*;
+    using functional::operator>>;
+    const auto scaled = asks(&Config::base)
+            >> [] (int base) { return fmap([base] (int factor) { return base * factor; }, asks(&Config::factor)); }
+            >> [] (int value) { return fpure<functional::Reader>(value + 1); };
+    // The whole chain is one nested closure: no std::function, nothing on the heap.
+    static_assert(std::is_trivially_copyable_v<decltype(scaled)>);
+    std::cout << "reader: " << scaled.run(Config{3, 4}) << '\n';
+    const auto doubled = local([] (const Config &config) { return Config{config.base, config.factor * 2}; }, scaled);
+    std::cout << "reader local: " << doubled.run(Config{3, 4}) << '\n';
+    const auto sum = fmap(functional::partially_applicable([] (int lhs, int rhs) { return lhs + rhs; }), asks(&Config::base))
+            * asks(&Config::factor);
+    std::cout << "reader apply: " << sum.run(Config{3, 4}) << '\n';
+
+    const auto next_id = functional::get_state()
+            >> [] (int id) { return fmap([id] (std::monostate) { return id; }, functional::modify_state([] (int state) { return state + 1; })); };
+    const auto two_ids = next_id
+            >> [next_id] (int first) { return fmap([first] (int second) { return std::pair{first, second}; }, next_id); };
+    static_assert(std::is_trivially_copyable_v<decltype(two_ids)>);
+    const auto [ids, counter] = functional::run_state(two_ids, 10);
+    std::cout << "state: ids " << ids.first << ", " << ids.second << ", counter " << counter << '\n';
+    std::cout << "state exec: " << functional::exec_state(functional::put_state(42) >> [] (std::monostate) { return functional::get_state(); }, 0) << '\n';
+    std::cout << '\n';
+}
+
+static void unique_function_test()
+{
+    std::cout << __PRETTY_FUNCTION__ << '\n';
+    using functional::detail::MoveOnlyData;
+    using functional::detail::MoveOnlyFunctionObject;
+    using functional::detail::MoveOnlyResult;
+    functional::UniqueFunction<MoveOnlyResult(MoveOnlyData &&)> move_only{MoveOnlyFunctionObject{}};
+    static_cast<void>(move_only(MoveOnlyData{}));
+
+    using Callback = functional::UniqueFunction<int(int)>;
+    auto owned = std::make_unique<int>(10);
+    Callback add_owned{[owned = std::move(owned)] (int value) { return value + *owned; }};
+    std::array<int, 16> table{};
+    std::iota(table.begin(), table.end(), 0);
+    Callback lookup{[table] (int value) { return table[static_cast<std::size_t>(value) % table.size()]; }};
+    static_assert(Callback::is_stored_inline_v<decltype([owned = std::make_unique<int>(0)] (int) { return 0; })>);
+    static_assert(!Callback::is_stored_inline_v<decltype([table] (int) { return 0; })>);
+    Callback moved = std::move(add_owned);
+    std::cout << "unique function: " << moved(5) << " " << lookup(21) << " empty after move: " << !add_owned << '\n';
+
+    functional::DynamicPipeline<std::optional, int> pipeline{3};
+    pipeline.map([] (int value) { return value + 1; })
+            .bind([owned = std::make_unique<int>(100)] (int value) {
+                return value < *owned ? std::optional<int>{value * 2} : std::nullopt;
+            })
+            .map([] (int value) { return value - 3; });
+    std::cout << "dynamic pipeline: " << pipeline.run(20) << " " << pipeline.run(200) << " stages: " << pipeline.size() << '\n';
+    std::cout << '\n';
+}
+
+// Local stand-in for a remote call: blocks the worker it runs on for a while.
+static functional::Task<double> fake_rpc(std::string endpoint, double value)
+{
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    std::cout << "\trpc " + endpoint + " done\n";
+    co_return value;
+}
+
+static void task_test()
+{
+    std::cout << __PRETTY_FUNCTION__ << '\n';
+    static_assert(functional::Monad<functional::Task>);
+    using functional::fmap;
+    using functional::fpure;
+    using functional::operator*;
+    using functional::operator>>;
+    using functional::partially_applicable;
+    const auto start = std::chrono::steady_clock::now();
+    auto aggregated =
+        fmap(partially_applicable([] (double price, double quantity, double discount) {
+                                      return price * quantity - discount;
+                                  }),
+             fake_rpc("price", 12.5))
+        * fake_rpc("quantity", 4.0)
+        * fake_rpc("discount", 7.0);
+    const double total = std::move(aggregated).get();
+    const auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+    std::cout << "fan-out: " << total << " on " << functional::ThreadPool::global().worker_count()
+              << " workers in " << elapsed.count() << "ms\n";
+    auto chained = fpure<functional::Task>(21)
+            >> [] (int value) { return fake_rpc("double", value * 2.0); };
+    const double doubled = std::move(chained).get();
+    std::cout << "bind: " << doubled << '\n';
+    std::cout << '\n';
+}
+
+static void traverse_test()
+{
+    std::cout << __PRETTY_FUNCTION__ << '\n';
+    using functional::sequence;
+    using functional::traverse;
+    const std::vector<std::optional<int>> all_present = {1, 2, 3};
+    std::cout << "sequence optional: " << sequence(all_present) << '\n';
+    std::cout << "sequence optional (missing): " << sequence(std::vector<std::optional<int>>{1, std::nullopt, 3}) << '\n';
+    const auto halve_even = [] (int value) {
+        return value % 2 == 0 ? std::optional{value / 2} : std::nullopt;
+    };
+    std::cout << "traverse optional: " << traverse(halve_even, std::vector{2, 4, 6}) << '\n';
+    // A view over an lvalue container is traversed in place, its elements are not moved out.
+    std::vector<std::string> words = {"kept", "skipped", "intact"};
+    const auto take_word = [] (std::string word) {
+        return std::optional{word.size()};
+    };
+    const auto lengths = traverse(take_word, std::views::filter(words, [] (const std::string &word) { return word != "skipped"; }));
+    std::cout << "traverse filter view: " << lengths->size() << " words, source still " << words[0] << ' ' << words[2] << '\n';
+    using test_functional::MyMonad;
+    std::cout << "sequence generic: " << sequence(std::vector{MyMonad<int>{1}, MyMonad<int>{2}}).value << '\n';
+    std::cout << '\n';
+}
+
+static void foldable_test()
+{
+    std::cout << __PRETTY_FUNCTION__ << '\n';
+    static_assert(functional::Foldable<std::vector>);
+    static_assert(functional::Foldable<std::optional>);
+    using functional::ffold;
+    using functional::ffold_map;
+    using functional::ffold_map_par;
+    using functional::Max;
+    using functional::Min;
+    using functional::Sum;
+    static_assert(functional::Monoid<Min<int>>);
+    static_assert(!functional::Monoid<Min<std::string>>, "numeric_limits<std::string>::max() is not a largest string");
+    const std::vector<std::string> words = {"fold", "able"};
+    std::cout << "fold strings: " << ffold(words) << '\n';
+    std::cout << "fold optional: " << ffold_map([] (int value) { return Max<int>{value}; }, std::optional{7}).value
+              << ", empty: " << ffold_map([] (int value) { return Sum<int>{value}; }, std::optional<int>{}).value << '\n';
+    std::vector<double> samples(1 << 20);
+    for (std::size_t idx = 0; idx < samples.size(); ++idx) {
+        samples[idx] = 1.0 / static_cast<double>(idx + 1);
+    }
+    const auto to_sum = [] (double value) { return Sum<double>{value}; };
+    const double first = ffold_map(to_sum, samples).value;
+    const double second = ffold_map(to_sum, samples).value;
+    const double parallel = ffold_map_par(to_sum, samples).value;
+    std::cout.precision(17);
+    std::cout << "tree sum: " << first << ", reproducible: " << (first == second) << ", parallel: " << (first == parallel) << '\n';
+    std::cout.precision(6);
+    std::cout << '\n';
+}
+
+static std::atomic<std::size_t> produced_lines = 0;
+
+// Unbounded stand-in for a tailed NDJSON log.
+static functional::Stream<std::string> tail_log()
+{
+    for (std::size_t idx = 0;; ++idx) {
+        ++produced_lines;
+        co_yield "{\"id\": " + std::to_string(idx) + "}";
+    }
+}
+
+static void stream_test()
+{
+    std::cout << __PRETTY_FUNCTION__ << '\n';
+    static_assert(functional::Monad<functional::Stream>);
+    using functional::fmap;
+    using functional::fpure;
+    using functional::operator>>;
+    auto line_lengths = fmap([] (std::string line) { return line.size(); }, functional::buffered(tail_log(), 4));
+    std::size_t consumed = 0;
+    std::size_t total_length = 0;
+    for (const auto length : line_lengths) {
+        total_length += length;
+        if (++consumed == 1000) {
+            break;
+        }
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    std::cout << "consumed " << consumed << " lines (" << total_length << " bytes), producer ran ahead by at most "
+              << produced_lines - consumed << '\n';
+    auto repeated = fpure<functional::Stream>(3)
+            >> [] (int count) -> functional::Stream<int> {
+                   for (int idx = 0; idx < count; ++idx) {
+                       co_yield idx * 10;
+                   }
+               };
+    std::cout << "bind:";
+    for (const auto value : repeated) {
+        std::cout << ' ' << value;
+    }
+    std::cout << "\n\n";
+}
+
+static void text_parser_test()
+{
+    std::cout << __PRETTY_FUNCTION__ << '\n';
+    static_assert(functional::Monad<functional::TextParser>);
+    static_assert(functional::Alternative<functional::TextParser>);
+    using namespace functional;
+    using namespace std::literals;
+    const auto identifier = token(take_while("a-zA-Z_", 1));
+    const auto number = fmap([] (std::string_view digits) {
+                                 int value = 0;
+                                 std::from_chars(digits.data(), digits.data() + digits.size(), value);
+                                 return value;
+                             },
+                             token(take_while("0-9", 1)));
+    const auto setting = fmap(partially_applicable([] (std::string_view key, std::string_view, int value) {
+                                                       return std::string(key) + "=" + std::to_string(value);
+                                                   }),
+                              identifier)
+        * token(literal("="))
+        * number;
+    const auto config = fmap(partially_applicable([] (std::string_view, std::vector<std::string> settings) { return settings; }),
+                             spaces())
+        * sep_by(setting, token(literal(";")));
+    std::cout << "config: " << parse_text(config, "  retries = 3; timeout=30 ;depth= 2"sv).value.value_or(std::vector<std::string>{}) << '\n';
+    const auto failed = parse_text(setting, "retries = ;"sv);
+    std::cout << "error at " << failed.error_position << ", expected \"" << failed.expected << "\"\n";
+    try
+    {
+        fpure<TextParser>(std::make_unique<int>(1));
+    }
+    catch (const std::invalid_argument &error)
+    {
+        std::cout << "move-only pure: " << error.what() << '\n';
+    }
+
+    std::size_t term_runs = 0;
+    const auto term = memoize(fmap([&term_runs] (int value) { ++term_runs; return value; }, number));
+    const auto sum = fmap(partially_applicable([] (int lhs, std::string_view, int rhs) { return lhs + rhs; }), term)
+        * token(literal("+")) * term;
+    const auto difference = fmap(partially_applicable([] (int lhs, std::string_view, int rhs) { return lhs - rhs; }), term)
+        * token(literal("-")) * term;
+    const auto expression = sum | difference | term;
+    std::cout << "packrat: 40 - 2 = " << parse_text(expression, "40 - 2"sv).value.value_or(0)
+              << " with " << term_runs << " term evaluations\n";
+
+    std::string words;
+    while (words.size() < (16u << 20)) {
+        words += "lorem ipsum dolor sit amet ";
+    }
+    const auto word_count = fmap([] (std::vector<std::string_view> tokens) { return tokens.size(); }, many(token(take_while("a-z", 1))));
+    const auto start = std::chrono::steady_clock::now();
+    const auto counted = parse_text(word_count, words);
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    std::cout << "tokens: " << counted.value.value_or(0) << " at " << static_cast<int>(words.size() / elapsed.count() / (1 << 20)) << " MB/s\n";
+    std::cout << '\n';
+}
+
 static void partially_applicable_test()
 {
     std::cout << __PRETTY_FUNCTION__ << '\n';
@@ -260,44 +600,451 @@ static void partially_applicable_test()
 namespace json_test
 {
 
-struct MyStruct final
+using test_functional::MyStruct;
+using test_functional::MyStructFields;
+using test_functional::parse_json;
+using test_functional::parse_json_fields;
+using test_functional::parse_records;
+
+void test_json()
 {
-    int a;
-    float b;
+    const json::JsonObject value = {
+        {"a", {12.0}},
+        {"b", {12.0}},
+    };
+    std::cout << parse_json(json::JsonValue{value}) << '\n';
+}
+
+void test_json_traverse()
+{
+    const json::JsonList records = {
+        json::JsonValue{json::JsonObject{{"a", {1.0}}, {"b", {2.0}}}},
+        json::JsonValue{json::JsonObject{{"a", {3.0}}, {"b", {4.0}}}},
+    };
+    const auto parsed = functional::traverse(parse_json, records);
+    std::cout << "traverse Parser: " << std::get<std::vector<MyStruct>>(parsed.value).size() << " records\n";
+    json::JsonList broken = records;
+    broken.push_back(json::JsonValue{json::JsonObject{{"a", {5.0}}}});
+    std::cout << "traverse Parser (broken): " << functional::traverse(parse_json, broken).error_prefix << '\n';
+}
+
+struct Labelled final
+{
+    json::JsonString label;
+    MyStruct payload;
 };
 
-std::ostream &operator<<(std::ostream &stream, const MyStruct &val)
+std::ostream &operator<<(std::ostream &stream, const Labelled &val)
 {
-    std::cout << "MyStruct{" << val.a << ", " << val.b << "}";
-    return stream;
+    return stream << "Labelled{" << val.label << ", " << val.payload << "}";
+}
+
+void test_json_fields()
+{
+    using namespace std::literals;
+    const json::JsonValue inputs[] = {
+        json::JsonValue{json::JsonObject{{"b", {2.5}}, {"ignored", {0.0}}, {"a", {1.0}}}},
+        json::JsonValue{json::JsonObject{{"a", {1.0}}}},
+        json::JsonValue{json::JsonObject{{"b", {2.5}}}},
+        json::JsonValue{json::JsonObject{{"a", {"one"}}, {"b", {2.5}}}},
+        json::JsonValue{json::JsonObject{{"a", {1.0}}, {"b", {"two"}}}},
+        // Derived reports "b", the first bad key in the object; hand-written "a", the first field.
+        json::JsonValue{json::JsonObject{{"b", {"two"}}, {"a", {"one"}}}},
+        json::JsonValue{json::JsonNumber{1.0}},
+    };
+    for (const auto &input : inputs)
+    {
+        std::cout << "derived: " << parse_json_fields(input) << '\n';
+        std::cout << "hand-written: " << parse_json(input) << '\n';
+    }
+    // The int member takes integral numbers in its range only.
+    std::cout << "derived fractional int: " << parse_json_fields(json::JsonValue{json::JsonObject{{"a", {1.7}}, {"b", {2.5}}}}) << '\n';
+    std::cout << "derived int out of range: " << parse_json_fields(json::JsonValue{json::JsonObject{{"a", {1e20}}, {"b", {2.5}}}}) << '\n';
+    constexpr auto labelled = json::with_fields<json::fields<
+            json::field<"label", &Labelled::label>,
+            json::field<"payload", &Labelled::payload, &parse_json_fields>>>("Labelled"sv);
+    const auto result = labelled(json::JsonValue{json::JsonObject{
+        {"label", {"point"}},
+        {"payload", json::JsonValue{json::JsonObject{{"a", {3.0}}, {"b", {4.0}}}}},
+    }});
+    std::cout << "derived nested: " << result << '\n';
+    std::cout << "derived nested error: " << labelled(json::JsonValue{json::JsonObject{
+        {"label", {"point"}},
+        {"payload", json::JsonValue{json::JsonObject{{"a", {3.0}}}}},
+    }}) << '\n';
+}
+
+void test_json_schema()
+{
+    const json::CompiledSchema schema{"Order", {
+        {"id", json::SchemaType::integer},
+        {"customer", json::SchemaType::string},
+        {"total", json::SchemaType::number},
+        {"note", json::SchemaType::string, false},
+    }};
+    const json::JsonValue order{json::JsonObject{{"total", {9.5}}, {"id", {42.0}}, {"customer", {"ada"}}}};
+    json::SchemaRow row;
+    std::cout << "schema fields found: " << schema.parse_into(order, row) << '\n';
+    std::cout << "schema row: id=" << *row.get<std::int64_t>(*schema.slot("id"))
+              << " customer=" << *row.get<std::string_view>(*schema.slot("customer"))
+              << " total=" << *row.get<json::JsonNumber>(*schema.slot("total"))
+              << " note=" << (row.get<std::string_view>(*schema.slot("note")) ? "set" : "absent") << '\n';
+    std::cout << "schema error: " << schema.parse_into(json::JsonValue{json::JsonObject{{"id", {4.5}}}}, row) << '\n';
+    std::cout << "schema error: " << schema.parse_into(json::JsonValue{json::JsonObject{{"id", {4.0}}}}, row) << '\n';
 }
 
-json::Parser<MyStruct> parse_json(const json::JsonValue &json_value)
+enum class Colour
+{
+    red,
+    green,
+    blue,
+    cyan,
+    magenta,
+    yellow,
+};
+
+std::ostream &operator<<(std::ostream &stream, Colour colour)
 {
-    using json::with_object;
-    using json::parse_field;
+    return stream << "Colour{" << static_cast<int>(colour) << "}";
+}
+
+constexpr auto parse_colour = json::enum_parser<Colour>("Colour", {
+    {"red", Colour::red},
+    {"green", Colour::green},
+    {"blue", Colour::blue},
+    {"cyan", Colour::cyan},
+    {"magenta", Colour::magenta},
+    {"yellow", Colour::yellow},
+});
+
+struct Pixel final
+{
+    Colour colour;
+    double x;
+};
+
+std::ostream &operator<<(std::ostream &stream, const Pixel &val)
+{
+    return stream << "Pixel{" << val.colour << ", " << val.x << "}";
+}
+
+json::Parser<Colour> parse_pixel_colour(const json::JsonValue &json_value)
+{
+    return parse_colour(json_value);
+}
+
+void test_json_enum()
+{
+    using namespace std::literals;
+    static_assert(parse_colour.find("magenta") == Colour::magenta);
+    static_assert(!parse_colour.find("purple"));
+    std::cout << "enum: " << parse_colour(json::JsonValue{"cyan"}) << '\n';
+    std::cout << "enum miss: " << parse_colour(json::JsonValue{"purple"}) << '\n';
+    std::cout << "enum not a string: " << parse_colour(json::JsonValue{1.0}) << '\n';
+    constexpr auto pixel = json::with_fields<json::fields<
+            json::field<"colour", &Pixel::colour, &parse_pixel_colour>,
+            json::field<"x", &Pixel::x>>>("Pixel"sv);
+    std::cout << "enum field: " << pixel(json::JsonValue{json::JsonObject{{"colour", {"blue"}}, {"x", {1.0}}}}) << '\n';
+    std::cout << "enum field miss: " << pixel(json::JsonValue{json::JsonObject{{"colour", {"teal"}}, {"x", {1.0}}}}) << '\n';
+}
+
+// Environment of a context-dependent parser, passed in through a functional::Reader.
+struct Units final
+{
+    double scale;
+};
+
+void test_json_reader()
+{
+    using json::JsonNumber;
+    using namespace std::literals;
+    constexpr auto parser = json::with_object_in(
+            "MyStruct"sv,
+            [] (const Units &units, const json::JsonObject &json_object) {
+                using namespace functional;
+                return fmap(partially_applicable([scale = units.scale] (JsonNumber a, JsonNumber b) {
+                                                     return MyStruct{static_cast<int>(a * scale), static_cast<float>(b * scale)};
+                                                 }),
+                            json::parse_field<JsonNumber>(json_object, "a"sv))
+                    * json::parse_field<JsonNumber>(json_object, "b"sv);
+            });
+    const json::JsonValue value{json::JsonObject{{"a", {1.0}}, {"b", {2.5}}}};
+    const auto reader = parser(value);
+    std::cout << "reader parse x1: " << reader.run(Units{1.0}) << '\n';
+    std::cout << "reader parse x100: " << reader.run(Units{100.0}) << '\n';
+    std::cout << "reader parse error: " << parser(json::JsonValue{JsonNumber{1.0}}).run(Units{1.0}) << '\n';
+}
+
+void test_json_validation()
+{
+    static_assert(functional::Applicative<json::Validation>);
     using json::JsonNumber;
+    using json::JsonString;
     using namespace std::literals;
-    constexpr auto parser = json::with_object(
+    const auto validate = [] (json::ValidationArena &arena, const json::JsonObject &object, const json::ValidationPath *path) {
+        using namespace functional;
+        return fmap(partially_applicable([] (JsonNumber a, JsonNumber b, JsonString) {
+                                             return MyStruct{static_cast<int>(a), static_cast<float>(b)};
+                                         }),
+                    json::validate_field<JsonNumber>(arena, object, "a"sv, path))
+            * json::validate_field<JsonNumber>(arena, object, "b"sv, path)
+            * json::validate_field<JsonString>(arena, object, "name"sv, path);
+    };
+    json::ValidationArena arena;
+    const json::ValidationPath record_path{nullptr, {}, 7};
+    const auto broken = validate(arena, json::JsonObject{{"b", {JsonString{"two"}}}}, &record_path);
+    for (const auto &line : json::render_errors(std::get<json::ValidationFailure>(broken.value)))
+    {
+        std::cout << "validation error: " << line << '\n';
+    }
+
+    const json::JsonObject good = {{"a", {1.0}}, {"b", {2.0}}, {"name", {JsonString{"x"}}}};
+    const json::JsonObject bad = {{"name", {1.0}}};
+    std::size_t valid = 0;
+    std::size_t errors = 0;
+    const auto start = std::chrono::steady_clock::now();
+    for (std::size_t idx = 0; idx < 1'000'000; ++idx)
+    {
+        arena.reset();
+        const json::ValidationPath path{nullptr, {}, idx};
+        const auto result = validate(arena, idx % 2 ? bad : good, &path);
+        if (const auto *failure = std::get_if<json::ValidationFailure>(&result.value))
+        {
+            errors += failure->errors->count;
+        }
+        else
+        {
+            ++valid;
+        }
+    }
+    const std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+    std::cout << "validated 1M records: " << valid << " valid, " << errors << " errors in " << static_cast<int>(elapsed.count()) << " ms\n";
+}
+
+void test_json_instrumentation()
+{
+    using json::JsonNumber;
+    using namespace std::literals;
+    constexpr auto parser = json::with_object<json::Instrumented>(
             "MyStruct"sv,
             [] (const json::JsonObject &json_object) {
                 using namespace functional;
                 return fmap(partially_applicable([] (JsonNumber a, JsonNumber b) {
                                                      return MyStruct{static_cast<int>(a), static_cast<float>(b)};
                                                  }),
-                            parse_field<JsonNumber>(json_object, "a"sv))
-                    * parse_field<JsonNumber>(json_object, "b"sv);
+                            json::parse_field<json::Instrumented, JsonNumber>(json_object, "a"sv))
+                    * json::parse_field<json::Instrumented, JsonNumber>(json_object, "b"sv);
             });
-    return parser(json_value);
+    const json::JsonValue valid{json::JsonObject{{"a", {1.0}}, {"b", {2.0}}}};
+    const json::JsonValue broken{json::JsonObject{{"a", {1.0}}}};
+    for (int idx = 0; idx < 1000; ++idx)
+    {
+        const auto result = parser(idx % 10 ? valid : broken);
+        static_cast<void>(result);
+    }
+    for (const auto &entry : json::instrumentation_snapshot())
+    {
+        std::cout << "instrumentation: " << entry << '\n';
+    }
 }
 
-void test_json()
+void test_json_cache()
 {
-    const json::JsonObject value = {
-        {"a", {12.0}},
-        {"b", {12.0}},
-    };
-    std::cout << parse_json(json::JsonValue{value}) << '\n';
+    json::CachedParser<MyStruct> cached{parse_json, {.capacity = 2, .shards = 1}};
+    const json::JsonValue tenant_a{json::JsonObject{{"a", {1.0}}, {"b", {2.0}}}};
+    const json::JsonValue tenant_b{json::JsonObject{{"a", {1.0}}, {"b", {2.0}}}};
+    const json::JsonValue other{json::JsonObject{{"a", {3.0}}, {"b", {4.0}}}};
+    const json::JsonValue broken{json::JsonObject{{"a", {3.0}}}};
+    const auto first = cached(tenant_a);
+    const auto second = cached(tenant_b);
+    std::cout << "cache: " << *second << " shared: " << (first == second) << '\n';
+    std::cout << "cache error: " << *cached(broken) << '\n';
+    static_cast<void>(cached(other));
+    std::cout << "cache: " << cached.stats() << '\n';
+    std::cout << "cache hash -0.0 == 0.0: " << (json::content_hash(json::JsonValue{-0.0}) == json::content_hash(json::JsonValue{0.0})) << '\n';
+    // A hit is confirmed against the cached document, not taken on the hash alone.
+    std::cout << "cache same content: " << json::same_content(tenant_a, tenant_b) << " reordered: "
+              << json::same_content(tenant_a, json::JsonValue{json::JsonObject{{"b", {2.0}}, {"a", {1.0}}}}) << '\n';
+    // Every document collides on this hash, as a crafted one would on content_hash.
+    json::CachedParser<MyStruct> colliding{parse_json, {.capacity = 2, .shards = 1, .hash = [] (const json::JsonValue &) {
+        return json::ContentHash{};
+    }}};
+    const auto victim = colliding(tenant_a);
+    const auto attacker = colliding(other);
+    std::cout << "cache collision: " << *attacker << " served victim's: " << (attacker == victim)
+              << " victim still cached: " << (colliding(tenant_b) == victim) << ' ' << colliding.stats() << '\n';
+}
+
+void test_json_persistent()
+{
+    const json::JsonValue config{json::JsonObject{
+        {"service", {json::JsonObject{{"name", {json::JsonString{"billing"}}}, {"replicas", {3.0}}}}},
+        {"limits", {json::JsonObject{{"a", {10.0}}, {"b", {0.5}}}}},
+    }};
+    // One persistent level: the sections are plain JsonValue leaves that the combinators read as they are.
+    json::JsonDocument document{json::PersistentJson::from_json(config, 1)};
+    const json::PersistentJson before = document.snapshot();
+    document.update([] (const json::PersistentJson &root) {
+        return root.set("limits", json::PersistentJson::leaf(json::JsonValue{json::JsonObject{{"a", {20.0}}, {"b", {0.5}}}}));
+    });
+    const json::PersistentJson after = document.snapshot();
+    std::cout << "persistent before: " << parse_json(*before.find("limits")->leaf()) << '\n';
+    std::cout << "persistent after: " << parse_json(*after.find("limits")->leaf()) << '\n';
+    std::cout << "persistent shared service: " << before.find("service")->shares_node_with(*after.find("service"))
+              << " shared limits: " << before.find("limits")->shares_node_with(*after.find("limits")) << '\n';
+
+    json::PersistentJson list = json::PersistentJson::list();
+    for (int idx = 0; idx < 40; ++idx)
+    {
+        list = list.push_back(json::PersistentJson::leaf({static_cast<json::JsonNumber>(idx)}));
+    }
+    const json::PersistentJson updated = list.set(std::size_t{33}, json::PersistentJson::leaf({-1.0}));
+    std::cout << "persistent list: size " << updated.size() << ", [33] " << std::get<json::JsonNumber>(list.at(33)->leaf()->value)
+              << " -> " << std::get<json::JsonNumber>(updated.at(33)->leaf()->value)
+              << ", [3] shared: " << list.at(3)->shares_node_with(*updated.at(3)) << '\n';
+
+    // Writers bump a counter while readers check that the versions they see never go back.
+    constexpr int writers = 2;
+    constexpr int readers = 4;
+    constexpr int updates_per_writer = 2000;
+    json::JsonDocument counter{json::PersistentJson::leaf({0.0})};
+    std::atomic<bool> writing = true;
+    std::atomic<bool> monotonic = true;
+    {
+        std::vector<std::jthread> threads;
+        for (int idx = 0; idx < readers; ++idx)
+        {
+            threads.emplace_back([&] {
+                double last = 0.0;
+                while (writing.load(std::memory_order_relaxed))
+                {
+                    const double seen = std::get<json::JsonNumber>(counter.snapshot().leaf()->value);
+                    if (seen < last)
+                    {
+                        monotonic = false;
+                    }
+                    last = seen;
+                }
+            });
+        }
+        std::vector<std::jthread> writer_threads;
+        for (int idx = 0; idx < writers; ++idx)
+        {
+            writer_threads.emplace_back([&counter] {
+                for (int update = 0; update < updates_per_writer; ++update)
+                {
+                    counter.update([] (const json::PersistentJson &current) {
+                        return json::PersistentJson::leaf({std::get<json::JsonNumber>(current.leaf()->value) + 1.0});
+                    });
+                }
+            });
+        }
+        writer_threads.clear();
+        writing = false;
+    }
+    std::cout << "persistent concurrent: " << std::get<json::JsonNumber>(counter.snapshot().leaf()->value) << " of " << writers * updates_per_writer
+              << " updates, monotonic: " << monotonic << ", lock-free: " << counter.is_lock_free() << '\n';
+}
+
+void test_json_constant()
+{
+    using namespace std::literals;
+    using namespace json::literals;
+    // Parsed, validated and decoded by the compiler; nothing of this runs at startup.
+    constexpr auto defaults = json::constant<R"({"a": 7, "b": 0.25, "tags": ["fast", "caf\u00e9"]})">;
+    constexpr MyStruct decoded = json::parse_constant(defaults.root(), json::with_fields<MyStructFields>("MyStruct"sv));
+    static_assert(decoded.a == 7);
+    std::cout << "constant decoded: " << decoded << '\n';
+    std::cout << "constant tag 1: " << *defaults.root().find("tags")->at(1)->string() << '\n';
+    std::cout << "constant at runtime: " << parse_json(defaults.root().to_json()) << '\n';
+    constexpr auto list = R"([1, 2.5e3, -0.125])"_json;
+    std::cout << "constant literal:";
+    list.root().for_each_element([] (json::ConstantValue value) { std::cout << ' ' << *value.number(); });
+    std::cout << '\n';
+}
+
+void test_json_path()
+{
+    const json::JsonValue order{json::JsonObject{
+        {"payload", {json::JsonObject{
+            {"items", {json::JsonList{
+                {json::JsonObject{{"price", {9.5}}}},
+                {json::JsonObject{{"price", {12.0}}, {"a", {1.0}}, {"b", {2.0}}}},
+            }}},
+            {"currency", {"EUR"}},
+        }}},
+    }};
+    std::cout << "path price: " << json::path<"/payload/items/1/price">.get<json::JsonNumber>(order) << '\n';
+    std::cout << "path parser: " << json::path<"/payload/items/1">.get(order, parse_json) << '\n';
+    std::cout << "path missing: " << json::Path{"/payload/items/2/price"}.get<json::JsonNumber>(order) << '\n';
+    std::cout << "path not container: " << json::Path{"/payload/currency/code"}.get<json::JsonString>(order) << '\n';
+    const json::PathSet paths{"/payload/currency", "/payload/items/0/price", "/payload/items/1/price", "/payload/discount"};
+    const json::PathResults results = paths.evaluate(order);
+    std::cout << "path set:";
+    for (std::size_t idx = 0; idx < paths.size(); ++idx)
+    {
+        std::cout << ' ' << (results[idx] ? "found" : "missing");
+    }
+    std::cout << '\n';
+}
+
+void test_json_string()
+{
+    std::string storage;
+    const std::string_view plain = "no escapes here, borrowed as is";
+    const auto borrowed = json::decode_string(plain, storage);
+    std::cout << "string borrowed: " << borrowed << " same bytes: " << (std::get<std::string_view>(borrowed.value).data() == plain.data()) << '\n';
+    std::cout << "string decoded: " << json::decode_string(R"(caf\u00e9 \"quoted\" tab\there)", storage) << '\n';
+    std::cout << "string bad escape: " << json::decode_string(R"(bad \q)", storage) << '\n';
+    std::cout << "string bad UTF-8: " << json::decode_string("overlong \xc0\xaf", storage) << '\n';
+    std::cout << "utf8 JsonString: " << json::parse_utf8_string(json::JsonValue{"gr\xc3\xbc\xc3\x9f"}) << '\n';
+    std::cout << "utf8 valid prefix: " << json::valid_utf8_prefix("abc\xe2\x82") << '\n';
+}
+
+void test_json_context()
+{
+    using namespace std::literals;
+    json::ParseContext context;
+    // Two rounds over the same shapes: the second one builds and parses from recycled storage.
+    for (int round = 0; round < 2; ++round)
+    {
+        json::JsonList records = context.acquire_list();
+        for (int idx = 0; idx < 3; ++idx)
+        {
+            json::JsonObject record = context.acquire_object();
+            record.emplace_back("a", json::JsonValue{static_cast<double>(idx)});
+            if (round == 0 || idx != 2)
+            {
+                record.emplace_back("b", json::JsonValue{0.5});
+            }
+            records.push_back(json::JsonValue{std::move(record)});
+        }
+        json::JsonValue document{std::move(records)};
+        auto parsed = context.parse(parse_records, document);
+        if (const auto *values = std::get_if<std::vector<MyStruct>>(&parsed.value))
+        {
+            std::cout << "context round " << round << ": " << values->size() << " records\n";
+        }
+        else
+        {
+            std::cout << "context round " << round << ": " << parsed.error_prefix << std::get<json::ParseError>(parsed.value).error_message << '\n';
+        }
+        context.recycle(std::move(parsed));
+        context.recycle(std::move(document));
+    }
+
+    // As a with_object_in environment, the context decodes strings into its arena.
+    constexpr auto parse_label = json::with_object_in("Label"sv, [] (const auto &context_ref, const json::JsonObject &json_object) {
+        auto text = json::parse_field<json::JsonString>(json_object, "text"sv);
+        if (const auto *raw = std::get_if<json::JsonString>(&text.value))
+        {
+            return context_ref.get().decode_string(*raw);
+        }
+        return json::Parser<std::string_view>{std::get<json::ParseError>(std::move(text.value)), std::move(text.error_prefix), std::move(text.error_suffix)};
+    });
+    const json::JsonValue label{json::JsonObject{{"text", {json::JsonString{R"(tab\tseparated \u00e9)"}}}}};
+    std::cout << "context decoded label: " << context.parse(parse_label, label) << '\n';
+    context.reset_arena();
 }
 
 } // namespace json_test
@@ -320,12 +1067,46 @@ int main()
     monad_test<std::optional>();
     alternative_test<std::optional>();
 
+    functor_test<functional::CompactOptional>();
+    applicative_test<functional::CompactOptional>();
+    monad_test<functional::CompactOptional>();
+    alternative_test<functional::CompactOptional>();
+
+    functor_test<std::vector>();
+    applicative_test<std::vector>();
+    monad_test<std::vector>();
+    alternative_test<std::vector>();
+
     functor_test<json::Parser>();
     applicative_test<json::Parser>();
     alternative_test<json::Parser>();
 
     optional_test();
+    compact_optional_test();
+    noexcept_test();
+    vector_test();
+    lazy_range_test();
+    reader_state_test();
+    unique_function_test();
+    task_test();
+    traverse_test();
+    foldable_test();
+    stream_test();
+    text_parser_test();
     json_test::test_json();
+    json_test::test_json_traverse();
+    json_test::test_json_fields();
+    json_test::test_json_schema();
+    json_test::test_json_enum();
+    json_test::test_json_reader();
+    json_test::test_json_validation();
+    json_test::test_json_instrumentation();
+    json_test::test_json_cache();
+    json_test::test_json_persistent();
+    json_test::test_json_constant();
+    json_test::test_json_path();
+    json_test::test_json_string();
+    json_test::test_json_context();
 
     return EXIT_SUCCESS;
 }
@@ -0,0 +1,175 @@
+#pragma once
+
+#include <ostream>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "functional_applicative.hpp"
+#include "functional_functor.hpp"
+#include "functional_monad.hpp"
+#include "functional_partially_applicable.hpp"
+#include "functional_traverse.hpp"
+#include "json.hpp"
+#include "json_fields.hpp"
+
+// Fixtures shared by main.cpp, the benchmarks and the allocation budget: MyMonad provides free
+// fmap/fapply/fjoin found by ADL, MyMonadMethods goes through the member-function traits, and
+// MyStruct is the record every JSON demo and scenario parses.
+namespace test_functional
+{
+
+template<typename T>
+struct MyMonad final {
+    T value;
+};
+
+template<typename Func, typename T>
+#define CALL_TEXT std::forward<Func>(func)(std::move(value.value))
+constexpr auto fmap(Func &&func, MyMonad<T> &&value) noexcept(noexcept(CALL_TEXT)) {
+    using functional::fpure;
+    return fpure<MyMonad>(CALL_TEXT);
+#undef CALL_TEXT
+}
+
+template<typename Func, typename T>
+#define CALL_TEXT std::forward<Func>(func)(value.value)
+constexpr auto fmap(Func &&func, const MyMonad<T> &value) noexcept(noexcept(CALL_TEXT)) {
+    using functional::fpure;
+    return fpure<MyMonad>(CALL_TEXT);
+#undef CALL_TEXT
+}
+
+template<typename Func, typename T>
+    requires functional::is_instance_v<MyMonad, T>
+#define CALL_TEXT fmap(std::move(func.value), std::forward<T>(value))
+constexpr auto fapply(MyMonad<Func> &&func, T &&value) noexcept(noexcept(CALL_TEXT)) {
+    return CALL_TEXT;
+#undef CALL_TEXT
+}
+
+template<typename Func, typename T>
+    requires functional::is_instance_v<MyMonad, T>
+#define CALL_TEXT fmap(func.value, std::forward<T>(value))
+constexpr auto fapply(const MyMonad<Func> &func, T &&value) noexcept(noexcept(CALL_TEXT)) {
+    return CALL_TEXT;
+#undef CALL_TEXT
+}
+
+template<typename T>
+    requires functional::is_instance_v<MyMonad, T>
+auto fjoin(MyMonad<T> &&value) {
+    return std::move(value.value);
+}
+
+template<typename T>
+    requires functional::is_instance_v<MyMonad, T>
+auto fjoin(const MyMonad<T> &value) {
+    return value.value;
+}
+
+template<typename T>
+    requires requires(T t, std::ostream &stream) {
+        { stream << t };
+    }
+std::ostream &operator<<(std::ostream &stream, const MyMonad<T> &value) {
+    return stream << "MyMonad{" << value.value << "}";
+}
+
+template<typename T>
+struct MyMonadMethods final {
+    T value;
+
+    template<typename Func>
+    constexpr auto map(Func &&func) const &
+    {
+        return MyMonadMethods<decltype(std::forward<Func>(func)(value))>{std::forward<Func>(func)(value)};
+    }
+
+    template<typename Func>
+    constexpr auto map(Func &&func) &&
+    {
+        return MyMonadMethods<decltype(std::forward<Func>(func)(std::move(value)))>{std::forward<Func>(func)(std::move(value))};
+    }
+
+    template<typename Func>
+    constexpr auto apply(const MyMonadMethods<Func> &func) const &
+    {
+        return MyMonadMethods<decltype(func.value(value))>{func.value(value)};
+    }
+
+    template<typename Func>
+    constexpr auto apply(const MyMonadMethods<Func> &func) &&
+    {
+        return MyMonadMethods<decltype(func.value(std::move(value)))>{func.value(std::move(value))};
+    }
+
+    constexpr auto join() const &
+    {
+        return value;
+    }
+
+    constexpr auto join() &&
+    {
+        return std::move(value);
+    }
+};
+
+template<typename T>
+    requires requires(T t, std::ostream &stream) {
+        { stream << t };
+    }
+std::ostream &operator<<(std::ostream &stream, const MyMonadMethods<T> &value) {
+    return stream << "MyMonadMethods{" << value.value << "}";
+}
+
+struct MyStruct final
+{
+    int a;
+    float b;
+};
+
+inline std::ostream &operator<<(std::ostream &stream, const MyStruct &val)
+{
+    return stream << "MyStruct{" << val.a << ", " << val.b << "}";
+}
+
+// The hand-written schema: one parse_field per member, combined applicatively.
+inline json::Parser<MyStruct> parse_json(const json::JsonValue &json_value)
+{
+    using json::parse_field;
+    using json::JsonNumber;
+    using namespace std::literals;
+    constexpr auto parser = json::with_object(
+            "MyStruct"sv,
+            [] (const json::JsonObject &json_object) {
+                using namespace functional;
+                return fmap(partially_applicable([] (JsonNumber a, JsonNumber b) {
+                                                     return MyStruct{static_cast<int>(a), static_cast<float>(b)};
+                                                 }),
+                            parse_field<JsonNumber>(json_object, "a"sv))
+                    * parse_field<JsonNumber>(json_object, "b"sv);
+            });
+    return parser(json_value);
+}
+
+// The same schema derived from the member table.
+using MyStructFields = json::fields<json::field<"a", &MyStruct::a>, json::field<"b", &MyStruct::b>>;
+
+inline json::Parser<MyStruct> parse_json_fields(const json::JsonValue &json_value)
+{
+    using namespace std::literals;
+    constexpr auto parser = json::with_fields<MyStructFields>("MyStruct"sv);
+    return parser(json_value);
+}
+
+inline json::Parser<std::vector<MyStruct>> parse_records(const json::JsonValue &json_value)
+{
+    using namespace std::literals;
+    constexpr auto parser = json::with_list("Records"sv, [] (const json::JsonList &json_list) {
+        return functional::traverse(parse_json, json_list);
+    });
+    return parser(json_value);
+}
+
+} // namespace test_functional